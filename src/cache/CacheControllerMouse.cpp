@@ -19,6 +19,7 @@
 #include "cache/space/CacheSpace.h"
 #include "widgets/core/SpaceWidgetCore.h"
 #include "utils/auto_value.h"
+#include "misc/Trace.h"
 #include <QDebug>
 
 namespace Qi
@@ -28,6 +29,7 @@ CacheControllerMouse::CacheControllerMouse(QWidget* owner, SpaceWidgetCore* widg
     : ControllerContext(owner, widgetCore),
       m_cacheSpaces(1, cacheSpace),
       m_capturingController(nullptr),
+      m_isHitKeysValid(false),
       m_isStopped(false),
       m_isBusy(false)
 {
@@ -63,6 +65,8 @@ void CacheControllerMouse::resume()
 
 void CacheControllerMouse::clear()
 {
+    m_isHitKeysValid = false;
+
     QVector<ControllerMouse*> activeControllers;
     activeControllers.swap(m_activeControllers);
 
@@ -168,7 +172,12 @@ void CacheControllerMouse::updateActiveControllers()
     Q_ASSERT(!m_capturingController);
     Q_ASSERT(!m_isBusy);
 
+    // same controllers are under the point
+    if (updateHitKeys())
+        return;
+
     auto_value<bool> isBusy(m_isBusy, true);
+    TraceScope traceScope("CacheControllerMouse::updateActiveControllers", "controllers");
 
     // try to activate controllers under the point
     // and get actually activated controllers
@@ -190,6 +199,28 @@ void CacheControllerMouse::updateActiveControllers()
     m_activeControllers.swap(activatedControllers);
 }
 
+bool CacheControllerMouse::updateHitKeys()
+{
+    QVector<ControllersHitKey> hitKeys(m_cacheSpaces.size());
+
+    bool isValid = true;
+    for (int i = 0; i < m_cacheSpaces.size(); ++i)
+    {
+        if (!m_cacheSpaces[i]->controllersHitKey(point, hitKeys[i]))
+        {
+            isValid = false;
+            break;
+        }
+    }
+
+    bool isSame = m_isHitKeysValid && isValid && (m_hitKeys == hitKeys);
+
+    m_hitKeys.swap(hitKeys);
+    m_isHitKeysValid = isValid;
+
+    return isSame;
+}
+
 void CacheControllerMouse::stopCapturing()
 {
     if (m_capturingController)
@@ -209,6 +240,7 @@ void CacheControllerMouse::notifyStartCapturing(ControllerMouse& controller)
         return;
 
     m_capturingController = &controller;
+    m_isHitKeysValid = false;
 }
 
 void CacheControllerMouse::notifyStopCapturing(ControllerMouse& controller)
@@ -221,6 +253,7 @@ void CacheControllerMouse::notifyStopCapturing(ControllerMouse& controller)
         return;
 
     m_capturingController = nullptr;
+    m_isHitKeysValid = false;
 }
 
 bool CacheControllerMouse::processEvent(QEvent* event)
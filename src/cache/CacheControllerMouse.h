@@ -18,6 +18,7 @@
 #define QI_CACHE_CONTROLLER_MOUSE_H
 
 #include "core/ControllerMouse.h"
+#include "cache/CacheItem.h"
 
 namespace Qi
 {
@@ -67,6 +68,7 @@ private:
 
     bool isEmpty() const { return m_activeControllers.empty(); }
     void updateActiveControllers();
+    bool updateHitKeys();
 
     template <typename Func> bool processFunc(Func func)
     {
@@ -115,6 +117,9 @@ private:
     QVector<QSharedPointer<CacheSpace>> m_cacheSpaces;
     QVector<ControllerMouse*> m_activeControllers;
     ControllerMouse* m_capturingController;
+    // controllers under the last point
+    QVector<ControllersHitKey> m_hitKeys;
+    bool m_isHitKeysValid;
     bool m_isStopped;
     bool m_isBusy;
 };
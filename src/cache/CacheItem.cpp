@@ -17,6 +17,9 @@
 #include "CacheItem.h"
 #include "core/View.h"
 #include "core/ControllerMouse.h"
+#include "misc/RenderStats.h"
+#include "misc/ViewProfiler.h"
+#include <algorithm>
 
 //#define DEBUG_RECTS
 
@@ -37,19 +40,24 @@ CacheItemInfo& CacheItemInfo::operator=(const CacheItemInfo& other)
     item = other.item;
     rect = other.rect;
     schema = other.schema;
+    layouts = other.layouts;
     return *this;
 }
 
 CacheItem::CacheItem()
     : m_isCacheViewValid(false),
-      m_isAnyFloatView(false)
+      m_isAnyFloatView(false),
+      m_controllersIndexID(0),
+      m_isControllersPointSensitive(false)
 {
 }
 
 CacheItem::CacheItem(const CacheItemInfo& info)
     : CacheItemInfo(info),
       m_isCacheViewValid(false),
-      m_isAnyFloatView(false)
+      m_isAnyFloatView(false),
+      m_controllersIndexID(0),
+      m_isControllersPointSensitive(false)
 {
 }
 
@@ -57,7 +65,9 @@ CacheItem::CacheItem(const CacheItem& other)
     : CacheItemInfo(other),
       m_cacheView(other.m_cacheView),
       m_isCacheViewValid(other.m_isCacheViewValid),
-      m_isAnyFloatView(other.m_isAnyFloatView)
+      m_isAnyFloatView(other.m_isAnyFloatView),
+      m_controllersIndexID(0),
+      m_isControllersPointSensitive(false)
 {
 }
 
@@ -68,6 +78,7 @@ CacheItem& CacheItem::operator=(const CacheItem& other)
     m_cacheView = other.m_cacheView;
     m_isCacheViewValid = other.m_isCacheViewValid;
     m_isAnyFloatView = other.m_isAnyFloatView;
+    invalidateControllersIndex();
 
     return *this;
 }
@@ -96,6 +107,16 @@ void CacheItem::invalidateCacheView()
 {
     m_cacheView.reset();
     m_isCacheViewValid = false;
+    invalidateControllersIndex();
+}
+
+qint64 CacheItem::memoryUsage() const
+{
+    qint64 bytes = sizeof(CacheItem) + containerMemory(m_controllersIndex);
+    if (m_cacheView)
+        bytes += sizeof(CacheView) + m_cacheView->subViewsMemoryUsage();
+
+    return bytes;
 }
 
 void CacheItem::correctRectangles(const QPoint &offset)
@@ -150,49 +171,77 @@ void CacheItem::drawRaw(QPainter *painter, const GuiContext& ctx, const QRect* v
 
     //*ctx.PreDrawCell(m_rect);
 
+    ViewProfilerScope profilerScope(schema.view.data(), ViewProfiler::OperationSchemaDraw);
     m_cacheView->draw(painter, ctx, item, rect, visibleRect);
     m_cacheView->cleanupDraw(painter, ctx, item, rect, visibleRect);
 
     //*ctx.PostDrawCell();
 }
 
-void CacheItem::tryActivateControllers(const ControllerContext& context, const CacheSpace& cacheSpace, const QRect* visibleRect, QVector<ControllerMouse*>& controllers) const
+bool CacheItem::isDrawReentrant() const
 {
-    // don't handle if CacheCellEx is not ready yet
-    if (!m_isCacheViewValid || !m_cacheView)
-        return;
+    if (drawProxy)
+        return false;
 
-    typedef QPair<ControllerMouse*, const CacheView*> ControllerInfo_t;
-    QVector<ControllerInfo_t> itemControllersInfo;
+    if (!m_cacheView)
+        return true;
 
-    // collect affected controllers
-    m_cacheView->forEachCacheView([&itemControllersInfo, &context](const CacheView* cacheView)->bool {
-        if (!cacheView->view()->controller())
-            return true;
+    return m_cacheView->forEachCacheView([](const CacheView* cacheView)->bool {
+        return cacheView->view()->isDrawReentrant();
+    });
+}
 
-        if (!cacheView->rect().contains(context.point))
-            return true;
+int CacheItem::drawPasses() const
+{
+    Q_ASSERT(m_isCacheViewValid);
 
-        itemControllersInfo.push_back(ControllerInfo_t(cacheView->view()->controller().data(), cacheView));
+    // proxy draws whole item in the first pass
+    if (drawProxy)
+        return 1 << ViewDrawPassBackground;
 
-        return true;
-    });
+    if (!m_cacheView)
+        return 0;
+
+    return m_cacheView->drawPasses();
+}
 
-    if (itemControllersInfo.isEmpty())
+void CacheItem::drawPass(QPainter* painter, const GuiContext& ctx, ViewDrawPass pass, const QRect* visibleRect)
+{
+    // proxy draws whole item at once
+    if (drawProxy)
+    {
+        if (pass == ViewDrawPassBackground)
+            drawProxy(this, painter, ctx, visibleRect);
         return;
+    }
 
-    // range controllers by priority from low to high
-    std::stable_sort(itemControllersInfo.begin(), itemControllersInfo.end(), [](const ControllerInfo_t& left, const ControllerInfo_t& right) {
-        return left.first->priority() < right.first->priority();
-    });
+    Q_ASSERT(m_isCacheViewValid);
+    if (!m_cacheView)
+        return;
 
-    // m_cacheView should exists at this time
-    Q_ASSERT(m_cacheView);
+    Q_ASSERT(m_cacheView->hasDrawPass(pass));
 
-    // activate controllers in reversed order
-    for (int i = itemControllersInfo.size() - 1; i >= 0; --i)
+    ViewProfilerScope profilerScope(schema.view.data(), ViewProfiler::OperationSchemaDraw);
+    m_cacheView->drawPass(painter, ctx, item, rect, visibleRect, pass);
+    m_cacheView->cleanupDraw(painter, ctx, item, rect, visibleRect);
+}
+
+void CacheItem::tryActivateControllers(const ControllerContext& context, const CacheSpace& cacheSpace, const QRect* visibleRect, QVector<ControllerMouse*>& controllers) const
+{
+    // don't handle if CacheCellEx is not ready yet
+    if (!m_isCacheViewValid || !m_cacheView)
+        return;
+
+    validateControllersIndex();
+
+    // index is already in activation order
+    for (int i = 0; i < m_controllersIndex.size(); ++i)
     {
-        itemControllersInfo[i].first->tryActivate(controllers, context, CacheContext(item, rect, *(itemControllersInfo[i].second), visibleRect), cacheSpace);
+        ControllerEntry entry = m_controllersIndex[i];
+        if (!entry.cacheView->rect().contains(context.point))
+            continue;
+
+        entry.controller->tryActivate(controllers, context, CacheContext(item, rect, *entry.cacheView, visibleRect), cacheSpace);
 
         // if CacheCellEx was invalidated during TryActivate -> stop activate controllers
         if (!m_cacheView)
@@ -203,6 +252,65 @@ void CacheItem::tryActivateControllers(const ControllerContext& context, const C
     }
 }
 
+bool CacheItem::controllersHitKey(const QPoint& point, ControllersHitKey& key) const
+{
+    key = ControllersHitKey();
+    key.cacheItem = this;
+    key.itemRect = rect;
+
+    // don't handle if CacheCellEx is not ready yet
+    if (!m_isCacheViewValid || !m_cacheView)
+        return true;
+
+    validateControllersIndex();
+
+    // one bit per view
+    if (m_isControllersPointSensitive || m_controllersIndex.size() > 64)
+        return false;
+
+    key.indexID = m_controllersIndexID;
+    for (int i = 0; i < m_controllersIndex.size(); ++i)
+    {
+        if (m_controllersIndex[i].cacheView->rect().contains(point))
+            key.hitMask |= (Q_UINT64_C(1) << i);
+    }
+
+    return true;
+}
+
+void CacheItem::validateControllersIndex() const
+{
+    if (m_controllersIndexID != 0)
+        return;
+
+    Q_ASSERT(m_cacheView);
+
+    // index ids are unique to distinguish rebuilt indices of the same item
+    static quint64 lastIndexID = 0;
+    m_controllersIndexID = ++lastIndexID;
+    m_isControllersPointSensitive = false;
+    m_controllersIndex.clear();
+
+    m_cacheView->forEachCacheView([this](const CacheView* cacheView)->bool {
+        ControllerMouse* controller = cacheView->view()->controller().data();
+        if (!controller)
+            return true;
+
+        ControllerEntry entry = { controller, cacheView };
+        m_controllersIndex.append(entry);
+        m_isControllersPointSensitive |= controller->isActivationPointSensitive();
+        return true;
+    });
+
+    // range controllers by priority from low to high
+    std::stable_sort(m_controllersIndex.begin(), m_controllersIndex.end(), [](const ControllerEntry& left, const ControllerEntry& right) {
+        return left.controller->priority() < right.controller->priority();
+    });
+
+    // activate controllers in reversed order
+    std::reverse(m_controllersIndex.begin(), m_controllersIndex.end());
+}
+
 bool CacheItem::tooltipByPoint(const QPoint& point, TooltipInfo &tooltipInfo) const
 {
     // don't handle if CacheCellEx is not ready yet
@@ -262,6 +370,26 @@ void CacheItem::validateCacheView(const GuiContext& ctx, const QRect* visibleRec
 
     if (schema.isValid())
     {
+        QString layoutKey;
+        bool isLayoutShared = layouts && schema.view->layoutKey(item, layoutKey);
+
+        // try to reuse layout of the same item
+        if (isLayoutShared)
+        {
+            m_cacheView = layouts->find(schema, rect, layoutKey, ctx);
+            if (m_cacheView)
+            {
+                RenderStats::count(&RenderStats::layoutsShared);
+                // only non-floating layouts are stored
+                m_isAnyFloatView = false;
+                m_isCacheViewValid = true;
+                return;
+            }
+        }
+
+        RenderStats::count(&RenderStats::layoutsComputed);
+        RenderStatsTimer timer(&RenderStats::layoutTime);
+
         QRect itemRect = rect;
         QVector<CacheView> cacheViews;
         CacheView* cacheView = schema.view->addCacheView(*schema.layout, ctx, item, cacheViews, itemRect, visibleItemRectPtr);
@@ -280,6 +408,10 @@ void CacheItem::validateCacheView(const GuiContext& ctx, const QRect* visibleRec
 
                 return true;
             });
+
+            // floating views depend on visible rect
+            if (isLayoutShared && !m_isAnyFloatView)
+                layouts->insert(schema, rect, layoutKey, ctx, *m_cacheView);
         }
     }
 
@@ -18,6 +18,7 @@
 #define QI_CACHE_ITEM_H
 
 #include "CacheView.h"
+#include "CacheLayouts.h"
 #include "core/ItemSchema.h"
 
 namespace Qi
@@ -38,8 +39,38 @@ public:
     ItemID item;
     QRect rect;
     ViewSchema schema;
+    // shared layouts of the items with the same schema
+    QSharedPointer<CacheLayouts> layouts;
 };
 
+class CacheItem;
+
+// identifies controllers under the mouse point
+class QI_EXPORT ControllersHitKey
+{
+public:
+    ControllersHitKey()
+        : cacheItem(nullptr), indexID(0), hitMask(0)
+    {}
+
+    const CacheItem* cacheItem;
+    // unique id of the item controllers index
+    quint64 indexID;
+    // bit per indexed view under the point
+    quint64 hitMask;
+    QRect itemRect;
+};
+
+inline bool operator==(const ControllersHitKey& left, const ControllersHitKey& right)
+{
+    return (left.cacheItem == right.cacheItem) && (left.indexID == right.indexID) && (left.hitMask == right.hitMask) && (left.itemRect == right.itemRect);
+}
+
+inline bool operator!=(const ControllersHitKey& left, const ControllersHitKey& right)
+{
+    return !(left == right);
+}
+
 class QI_EXPORT CacheItem: public CacheItemInfo
 {
 public:
@@ -58,21 +89,46 @@ public:
     void validateCacheView(const GuiContext& ctx, const QRect* visibleRect = nullptr);
     void correctRectangles(const QPoint& offset);
 
+    // returns approximate memory used by the item and its view tree in bytes
+    qint64 memoryUsage() const;
+
     QSize calculateItemSize(const GuiContext& ctx, ViewSizeMode sizeMode = ViewSizeModeExact) const;
     QString text() const;
     void tryActivateControllers(const ControllerContext& context, const CacheSpace& cacheSpace, const QRect* visibleRect, QVector<ControllerMouse*>& controllers) const;
+    // returns false if controllers under the point cannot be identified by key
+    bool controllersHitKey(const QPoint& point, ControllersHitKey& key) const;
     bool tooltipByPoint(const QPoint& point, TooltipInfo& tooltipInfo) const;
 
     std::function<void(CacheItem*, QPainter*, const GuiContext&, const QRect*)> drawProxy;
 
     void draw(QPainter* painter, const GuiContext& ctx, const QRect* visibleRect = nullptr);
     void drawRaw(QPainter* painter, const GuiContext& ctx, const QRect* visibleRect = nullptr);
+    // returns true if all views of the item may be drawn in worker threads
+    bool isDrawReentrant() const;
+    // returns mask of passes (1 << pass) the validated item is drawn in
+    int drawPasses() const;
+    // draws views of the pass only, the item should be validated
+    void drawPass(QPainter* painter, const GuiContext& ctx, ViewDrawPass pass, const QRect* visibleRect = nullptr);
 
 
 private:
+    void validateControllersIndex() const;
+    void invalidateControllersIndex() const { m_controllersIndex.clear(); m_controllersIndexID = 0; }
+
     QSharedPointer<CacheView> m_cacheView;
     bool m_isCacheViewValid;
     bool m_isAnyFloatView;
+
+    // views with controllers in activation order (by priority from high to low)
+    struct ControllerEntry
+    {
+        ControllerMouse* controller;
+        const CacheView* cacheView;
+    };
+    mutable QVector<ControllerEntry> m_controllersIndex;
+    // 0 - index is not built
+    mutable quint64 m_controllersIndexID;
+    mutable bool m_isControllersPointSensitive;
 };
 
 } // end namespace Qi
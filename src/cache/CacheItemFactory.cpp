@@ -17,13 +17,15 @@
 #include "CacheItemFactory.h"
 #include "core/ext/Layouts.h"
 #include "core/ext/ViewComposite.h"
+#include "misc/RenderStats.h"
 
 namespace Qi
 {
 
 CacheItemFactory::CacheItemFactory(const Space& space, ViewApplicationMask viewApplicationMask)
     : m_space(space),
-      m_viewApplicationMask(viewApplicationMask)
+      m_viewApplicationMask(viewApplicationMask),
+      m_layouts(QSharedPointer<CacheLayouts>::create())
 {
 }
 
@@ -31,12 +33,14 @@ CacheItemFactory::~CacheItemFactory()
 {
 }
 
-CacheItemInfo CacheItemFactory::create(const ItemID& visibleItem) const
+CacheItemInfo CacheItemFactory::create(const ItemID& visibleItem, const SpacePoint& origin) const
 {
+    RenderStats::count(&RenderStats::itemsCreated);
+
     CacheItemInfo info;
     info.item = m_space.toAbsolute(visibleItem);
     updateSchema(info);
-    info.rect = m_space.itemRect(visibleItem);
+    info.rect = m_space.localItemRect(visibleItem, origin);
 
     return info;
 }
@@ -45,6 +49,18 @@ void CacheItemFactory::updateSchema(CacheItemInfo& info) const
 {
     Q_ASSERT(info.item.isValid());
     initSchemaImpl(info);
+    info.layouts = m_layouts;
+}
+
+void CacheItemFactory::setLayoutsShared(bool shared)
+{
+    if (isLayoutsShared() == shared)
+        return;
+
+    if (shared)
+        m_layouts = QSharedPointer<CacheLayouts>::create();
+    else
+        m_layouts.reset();
 }
 
 void CacheItemFactory::initSchemaImpl(CacheItemInfo& info) const
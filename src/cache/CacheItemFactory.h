@@ -31,11 +31,19 @@ public:
     CacheItemFactory(const Space& space, ViewApplicationMask viewApplicationMask);
     virtual ~CacheItemFactory();
 
-    CacheItemInfo create(const ItemID& visibleItem) const;
+    // item rectangle is relative to origin point of the space
+    CacheItemInfo create(const ItemID& visibleItem, const SpacePoint& origin = SpacePoint()) const;
     void updateSchema(CacheItemInfo& info) const;
 
     const Space& space() const { return m_space; }
 
+    // shares layouts between items with the same schema and size
+    bool isLayoutsShared() const { return !m_layouts.isNull(); }
+    void setLayoutsShared(bool shared);
+
+    // returns approximate memory used by the factory in bytes
+    qint64 memoryUsage() const { return sizeof(*this) + (m_layouts ? m_layouts->memoryUsage() : 0); }
+
 protected:
     virtual void initSchemaImpl(CacheItemInfo& info) const;
 
@@ -44,6 +52,7 @@ protected:
 private:
     const Space& m_space;
     ViewApplicationMask m_viewApplicationMask;
+    QSharedPointer<CacheLayouts> m_layouts;
 };
 
 QI_EXPORT QSharedPointer<CacheItemFactory> createCacheItemFactoryDefault(const Space& space, ViewApplicationMask viewApplicationMask);
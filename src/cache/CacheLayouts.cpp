@@ -0,0 +1,101 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "CacheLayouts.h"
+
+namespace Qi
+{
+
+CacheLayouts::CacheLayouts(int maxSize)
+    : m_layouts(maxSize)
+{
+    Q_ASSERT(maxSize > 0);
+}
+
+CacheLayouts::~CacheLayouts()
+{
+}
+
+void CacheLayouts::setMaxSize(int maxSize)
+{
+    Q_ASSERT(maxSize > 0);
+    m_layouts.setMaxCost(maxSize);
+}
+
+QSharedPointer<CacheView> CacheLayouts::find(const ViewSchema& schema, const QRect& itemRect, const QString& layoutKey, const GuiContext& ctx) const
+{
+    const Entry* entry = m_layouts.object(makeKey(schema, itemRect, layoutKey, ctx));
+    if (!entry)
+        return QSharedPointer<CacheView>();
+
+    QSharedPointer<CacheView> cacheView(new CacheView(entry->cacheView));
+
+    // move relative layout to the item
+    QPoint offset = itemRect.topLeft();
+    cacheView->forEachCacheView([&offset](CacheView* cacheView)->bool {
+        cacheView->rRect().translate(offset);
+        return true;
+    });
+
+    return cacheView;
+}
+
+void CacheLayouts::insert(const ViewSchema& schema, const QRect& itemRect, const QString& layoutKey, const GuiContext& ctx, const CacheView& cacheView)
+{
+    CacheView relativeCacheView(cacheView);
+
+    // store layout relative to the item
+    QPoint offset = -itemRect.topLeft();
+    relativeCacheView.forEachCacheView([&offset](CacheView* cacheView)->bool {
+        cacheView->rRect().translate(offset);
+        return true;
+    });
+
+    // least recently used layout is dropped if cache is full
+    m_layouts.insert(makeKey(schema, itemRect, layoutKey, ctx), new Entry(schema, relativeCacheView));
+}
+
+void CacheLayouts::clear()
+{
+    m_layouts.clear();
+}
+
+qint64 CacheLayouts::memoryUsage() const
+{
+    qint64 bytes = sizeof(*this);
+    for (const auto& key: m_layouts.keys())
+    {
+        // keys and entries are heap allocated nodes
+        bytes += sizeof(Key) + sizeof(Entry) + key.layoutKey.capacity() * sizeof(QChar);
+        bytes += m_layouts.object(key)->cacheView.subViewsMemoryUsage();
+    }
+
+    return bytes;
+}
+
+CacheLayouts::Key CacheLayouts::makeKey(const ViewSchema& schema, const QRect& itemRect, const QString& layoutKey, const GuiContext& ctx)
+{
+    Key key;
+    key.layout = schema.layout.data();
+    key.view = schema.view.data();
+    key.size = itemRect.size();
+    key.layoutKey = layoutKey;
+    key.style = ctx.style();
+    key.font = ctx.widget->font();
+    return key;
+}
+
+} // end namespace Qi
@@ -0,0 +1,96 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef QI_CACHE_LAYOUTS_H
+#define QI_CACHE_LAYOUTS_H
+
+#include "CacheView.h"
+#include "core/ItemSchema.h"
+#include <QCache>
+#include <QFont>
+
+namespace Qi
+{
+
+// stores view trees laid out relative to item's top-left corner
+// items with the same schema, size, layout key, font and style share the same tree
+// least recently used trees are dropped when maxSize is reached
+class QI_EXPORT CacheLayouts
+{
+    Q_DISABLE_COPY(CacheLayouts)
+
+public:
+    explicit CacheLayouts(int maxSize = 4096);
+    ~CacheLayouts();
+
+    int size() const { return m_layouts.size(); }
+    int maxSize() const { return m_layouts.maxCost(); }
+    void setMaxSize(int maxSize);
+
+    // creates view tree for itemRect from cached layout
+    QSharedPointer<CacheView> find(const ViewSchema& schema, const QRect& itemRect, const QString& layoutKey, const GuiContext& ctx) const;
+    // stores view tree laid out for itemRect
+    void insert(const ViewSchema& schema, const QRect& itemRect, const QString& layoutKey, const GuiContext& ctx, const CacheView& cacheView);
+
+    void clear();
+
+    // returns approximate memory used by stored layouts in bytes
+    qint64 memoryUsage() const;
+
+private:
+    struct Key
+    {
+        const Layout* layout;
+        const View* view;
+        QSize size;
+        QString layoutKey;
+        // text extents depend on font and style
+        const QStyle* style;
+        QFont font;
+
+        bool operator==(const Key& other) const
+        {
+            return layout == other.layout && view == other.view && size == other.size && style == other.style
+                    && layoutKey == other.layoutKey && font == other.font;
+        }
+
+        friend uint qHash(const Key& key)
+        {
+            return ::qHash(key.view) ^ ::qHash(key.layout) ^ ::qHash(QPair<int, int>(key.size.width(), key.size.height()))
+                    ^ ::qHash(key.layoutKey) ^ ::qHash(key.style) ^ ::qHash(key.font);
+        }
+    };
+
+    struct Entry
+    {
+        // holds schema to keep Key pointers unique
+        ViewSchema schema;
+        CacheView cacheView;
+
+        Entry(const ViewSchema& schema, const CacheView& cacheView)
+            : schema(schema), cacheView(cacheView)
+        {}
+    };
+
+    static Key makeKey(const ViewSchema& schema, const QRect& itemRect, const QString& layoutKey, const GuiContext& ctx);
+
+    // lookup updates recently used order
+    mutable QCache<Key, Entry> m_layouts;
+};
+
+} // end namespace Qi
+
+#endif // QI_CACHE_LAYOUTS_H
@@ -17,6 +17,7 @@
 #include "CacheView.h"
 #include "core/Layout.h"
 #include "core/View.h"
+#include "utils/MemoryUsage.h"
 
 //#define DEBUG_RECTS
 
@@ -46,7 +47,7 @@ CacheView::CacheView(const CacheView& other)
     : m_layout(other.m_layout),
       m_view(other.m_view),
       m_rect(other.m_rect),
-      m_showTooltip(other.m_showTooltip),
+      m_showTooltip(other.m_showTooltip.load()),
       m_subViews(other.m_subViews)
 {
 }
@@ -60,7 +61,7 @@ CacheView& CacheView::operator=(const CacheView& other)
     m_layout = other.m_layout;
     m_view =other.m_view;
     m_rect = other.m_rect;
-    m_showTooltip = other.m_showTooltip;
+    m_showTooltip.store(other.m_showTooltip.load());
     m_subViews= other.m_subViews;
     return *this;
 }
@@ -82,9 +83,9 @@ void CacheView::drawRaw(QPainter* painter, const GuiContext &ctx, const ItemID&
     painter->restore();
 #endif
     
-    m_showTooltip = false;
-
-    m_view->draw(painter, ctx, CacheContext(item, itemRect, *this, visibleRect), &m_showTooltip);
+    bool showTooltip = false;
+    m_view->draw(painter, ctx, CacheContext(item, itemRect, *this, visibleRect), &showTooltip);
+    m_showTooltip.store(showTooltip);
 
     // exclude rect of float views because they can overlap other views
     if (m_layout->isFloat())
@@ -98,12 +99,79 @@ void CacheView::cleanupDraw(QPainter* painter, const GuiContext &ctx, const Item
     m_view->cleanupDraw(painter, ctx, CacheContext(item, itemRect, *this, visibleRect));
 }
 
+void CacheView::drawPass(QPainter* painter, const GuiContext& ctx, const ItemID& item, const QRect& itemRect, const QRect* visibleRect, ViewDrawPass pass) const
+{
+    if (m_view->drawPass() != ViewDrawPassSubViews)
+    {
+        Q_ASSERT(m_view->drawPass() == pass);
+        draw(painter, ctx, item, itemRect, visibleRect);
+        return;
+    }
+
+    // views after the last view of the pass don't affect it
+    int lastIndex = m_subViews.size() - 1;
+    while (lastIndex >= 0 && !m_subViews[lastIndex].hasDrawPass(pass))
+        --lastIndex;
+
+    for (int i = 0; i <= lastIndex; ++i)
+    {
+        const auto& subCacheView = m_subViews[i];
+        if (subCacheView.hasDrawPass(pass))
+            subCacheView.drawPass(painter, ctx, item, itemRect, visibleRect, pass);
+        else
+            subCacheView.m_view->drawState(painter, ctx, CacheContext(item, itemRect, subCacheView, visibleRect));
+    }
+
+    // restore draw state in reversed order
+    for (int i = lastIndex; i >= 0; --i)
+    {
+        m_subViews[i].cleanupDraw(painter, ctx, item, itemRect, visibleRect);
+    }
+}
+
+bool CacheView::hasDrawPass(ViewDrawPass pass) const
+{
+    ViewDrawPass viewPass = m_view->drawPass();
+    if (viewPass != ViewDrawPassSubViews)
+        return viewPass == pass;
+
+    for (const auto& subCacheView: m_subViews)
+    {
+        if (subCacheView.hasDrawPass(pass))
+            return true;
+    }
+
+    return false;
+}
+
+int CacheView::drawPasses() const
+{
+    ViewDrawPass viewPass = m_view->drawPass();
+    if (viewPass != ViewDrawPassSubViews)
+        return 1 << viewPass;
+
+    int passes = 0;
+    for (const auto& subCacheView: m_subViews)
+        passes |= subCacheView.drawPasses();
+
+    return passes;
+}
+
 bool CacheView::tooltipText(const ItemID& item, QString& tooltipText) const
 {
-    if (!m_showTooltip)
+    if (!m_showTooltip.load())
         return false;
 
     return m_view->tooltipText(item, tooltipText);
 }
 
+qint64 CacheView::subViewsMemoryUsage() const
+{
+    qint64 bytes = containerMemory(m_subViews);
+    for (const auto& subView: m_subViews)
+        bytes += subView.subViewsMemoryUsage();
+
+    return bytes;
+}
+
 } // end namespace Qi
@@ -18,7 +18,9 @@
 */
 
 #include "core/ItemID.h"
+#include "core/misc/ViewAuxiliary.h"
 #include <QVector>
+#include <QAtomicInt>
 #include <QPainter>
 #include <functional>
 
@@ -55,9 +57,19 @@ public:
 
     void cleanupDraw(QPainter* painter, const GuiContext &ctx, const ItemID& item, const QRect& itemRect, const QRect* visibleRect = nullptr) const;
 
+    // draws views of the pass only
+    void drawPass(QPainter* painter, const GuiContext &ctx, const ItemID& item, const QRect& itemRect, const QRect* visibleRect, ViewDrawPass pass) const;
+    // returns true if any view is drawn in the pass
+    bool hasDrawPass(ViewDrawPass pass) const;
+    // returns mask of passes (1 << pass) the views are drawn in
+    int drawPasses() const;
+
     // retruns tooltip text
     bool tooltipText(const ItemID& item, QString& tooltipText) const;
 
+    // returns approximate memory used by sub views in bytes
+    qint64 subViewsMemoryUsage() const;
+
     template <typename Pred>
     bool forEachCacheView(Pred pred)
     {
@@ -92,7 +104,8 @@ protected:
     const Layout* m_layout;
     const View* m_view;
     QRect m_rect;
-    mutable bool m_showTooltip;
+    // may be updated by several drawing threads
+    mutable QAtomicInt m_showTooltip;
 
     QVector<CacheView> m_subViews;
 };
@@ -19,11 +19,52 @@
 #include "cache/CacheItem.h"
 #include "cache/CacheItemFactory.h"
 #include "misc/CacheSpaceAnimation.h"
+#include "misc/RenderStats.h"
+#include "misc/Trace.h"
+#include "misc/GridLinesBatch.h"
+#include "misc/ViewProfiler.h"
+#include "utils/PainterState.h"
 #include "utils/auto_value.h"
+#include <QThreadPool>
+#include <QSemaphore>
+#include <QPainter>
+#include <QPaintEngine>
+#include <QFontDatabase>
+#include <QtMath>
 
 namespace Qi
 {
 
+// lower bands are not worth a thread
+static const int MinBandHeight = 128;
+
+// band workers don't compete with application tasks in the global pool
+static QThreadPool* drawBandsPool()
+{
+    static QThreadPool pool;
+    return &pool;
+}
+
+class DrawBandTask: public QRunnable
+{
+public:
+    DrawBandTask(const std::function<void()>& draw, QSemaphore& done)
+        : m_draw(draw),
+          m_done(done)
+    {
+    }
+
+    void run() override
+    {
+        m_draw();
+        m_done.release();
+    }
+
+private:
+    std::function<void()> m_draw;
+    QSemaphore& m_done;
+};
+
 CacheSpace::CacheSpace(const QSharedPointer<Space>& space, ViewApplicationMask viewApplicationMask)
     : m_space(space),
       m_viewApplicationMask(viewApplicationMask),
@@ -32,7 +73,9 @@ CacheSpace::CacheSpace(const QSharedPointer<Space>& space, ViewApplicationMask v
       m_scrollDelta(0, 0),
       m_sizeDelta(0, 0),
       m_itemsCacheInvalid(true),
-      m_cacheIsInUse(false)
+      m_cacheIsInUse(false),
+      m_isDrawPassesEnabled(false),
+      m_drawThreads(0)
 {
     connect(m_space.data(), &Space::spaceChanged, this, &CacheSpace::onSpaceChanged);
 
@@ -45,7 +88,7 @@ CacheSpace::~CacheSpace()
     disconnect(m_space.data(), &Space::spaceChanged, this, &CacheSpace::onSpaceChanged);
 }
 
-void CacheSpace::onSpaceChanged(const Space* space, ChangeReason reason)
+void CacheSpace::onSpaceChanged(const Space* space, ChangeReason reason, const ChangedItems& items)
 {
     Q_UNUSED(space);
     Q_ASSERT(space == m_space.data());
@@ -54,30 +97,66 @@ void CacheSpace::onSpaceChanged(const Space* space, ChangeReason reason)
     {
         // invalidate all items
         clearItemsCache();
-        invalidateItemsCache(reason|ChangeReasonCacheItems);
+        invalidateItemsCache(reason|ChangeReasonCacheItems, m_window);
     }
     else if (reason & (ChangeReasonSpaceHint | ChangeReasonSpaceItemsStructure))
     {
         // update items factory
         updateCacheItemsFactory();
-        emit cacheChanged(this, reason|ChangeReasonCacheItems);
+        RenderStats::countInvalidation(reason|ChangeReasonCacheItems);
+        emit cacheChanged(this, reason|ChangeReasonCacheItems, m_window, items);
     }
     else if (reason & ChangeReasonSpaceItemsContent)
     {
         // forward event
-        emit cacheChanged(this, reason|ChangeReasonCacheContent);
+        RenderStats::countInvalidation(reason|ChangeReasonCacheContent);
+        emit cacheChanged(this, reason|ChangeReasonCacheContent, itemsWindowRegion(items), items);
     }
 }
 
+QRegion CacheSpace::itemsWindowRegion(const ChangedItems& items) const
+{
+    // cached items are out of date
+    if (items.isAll() || m_itemsCacheInvalid)
+        return m_window;
+
+    QRegion region;
+    forEachCacheItemImpl([&items, &region](const QSharedPointer<CacheItem>& cacheItem)->bool {
+        if (items.hasItem(cacheItem->item))
+            region += cacheItem->rect;
+        return true;
+    });
+
+    return region.intersected(m_window);
+}
+
 void CacheSpace::setViewApplicationMask(ViewApplicationMask viewApplicationMask)
 {
     if (m_viewApplicationMask != viewApplicationMask)
     {
         updateCacheItemsFactory();
-        emit cacheChanged(this, ChangeReasonCacheItems);
+        RenderStats::countInvalidation(ChangeReasonCacheItems);
+        emit cacheChanged(this, ChangeReasonCacheItems, m_window);
     }
 }
 
+void CacheSpace::setDrawPassesEnabled(bool enabled)
+{
+    if (m_isDrawPassesEnabled == enabled)
+        return;
+
+    m_isDrawPassesEnabled = enabled;
+
+    RenderStats::countInvalidation(ChangeReasonCacheContent);
+    emit cacheChanged(this, ChangeReasonCacheContent, m_window);
+}
+
+void CacheSpace::setDrawThreads(int threads)
+{
+    Q_ASSERT(threads >= 0);
+    m_drawThreads = threads;
+}
+
 void CacheSpace::setWindow(const QRect& window)
 {
     if (m_window == window)
@@ -88,9 +167,11 @@ void CacheSpace::setWindow(const QRect& window)
     QPoint delta = _window.topLeft() - m_window.topLeft();
     m_scrollDelta += delta;
     m_sizeDelta += (_window.size() - m_window.size());
+    // both old and new areas are affected
+    QRegion windowRegion = QRegion(m_window).united(_window);
     m_window = _window;
 
-    invalidateItemsCache(ChangeReasonCacheItems|ChangeReasonCacheFrame);
+    invalidateItemsCache(ChangeReasonCacheItems|ChangeReasonCacheFrame, windowRegion);
 }
 
 void CacheSpace::setScrollOffset(const QPoint& scrollOffset)
@@ -102,7 +183,24 @@ void CacheSpace::setScrollOffset(const QPoint& scrollOffset)
     m_scrollDelta += offset;
     m_scrollOffset = scrollOffset;
 
-    invalidateItemsCache(ChangeReasonCacheItems|ChangeReasonCacheFrame);
+    invalidateItemsCache(ChangeReasonCacheItems|ChangeReasonCacheFrame, m_window);
+}
+
+void CacheSpace::setScrollPosition(const SpacePoint& scrollPosition)
+{
+    // keep local scroll offset far from int limits
+    static const qint64 originStep = Q_INT64_C(1) << 30;
+
+    SpacePoint spaceOrigin((scrollPosition.x / originStep) * originStep, (scrollPosition.y / originStep) * originStep);
+    if (m_spaceOrigin != spaceOrigin)
+    {
+        // all cached rectangles are relative to the old origin
+        m_spaceOrigin = spaceOrigin;
+        clearItemsCache();
+        invalidateItemsCache(ChangeReasonCacheItems, m_window);
+    }
+
+    setScrollOffset(QPoint(int(scrollPosition.x - m_spaceOrigin.x), int(scrollPosition.y - m_spaceOrigin.y)));
 }
 
 void CacheSpace::set(const QRect& window, const QPoint& scrollOffset)
@@ -124,15 +222,16 @@ QPoint CacheSpace::space2Window(const QPoint& spacePoint) const
 void CacheSpace::clear()
 {
     clearItemsCache();
-    invalidateItemsCache(ChangeReasonCacheItems);
+    invalidateItemsCache(ChangeReasonCacheItems, m_window);
 }
 
-void CacheSpace::invalidateItemsCache(ChangeReason reason)
+void CacheSpace::invalidateItemsCache(ChangeReason reason, const QRegion& windowRegion)
 {
     Q_ASSERT(!m_cacheIsInUse);
     m_itemsCacheInvalid = true;
 
-    emit cacheChanged(this, reason);
+    RenderStats::countInvalidation(reason);
+    emit cacheChanged(this, reason, windowRegion);
 }
 
 void CacheSpace::clearItemsCache() const
@@ -143,7 +242,7 @@ void CacheSpace::clearItemsCache() const
 
 QSharedPointer<CacheItem> CacheSpace::createCacheItem(const ItemID& visibleItem) const
 {
-    return QSharedPointer<CacheItem>::create(m_cacheItemsFactory->create(visibleItem));
+    return QSharedPointer<CacheItem>::create(m_cacheItemsFactory->create(visibleItem, m_spaceOrigin));
 }
 
 void CacheSpace::validateItemsCache() const
@@ -151,6 +250,8 @@ void CacheSpace::validateItemsCache() const
     if (!m_itemsCacheInvalid)
         return;
 
+    RenderStatsTimer timer(&RenderStats::validateTime);
+    TraceScope traceScope("CacheSpace::validateItemsCache", "cache");
     validateItemsCacheImpl();
 }
 
@@ -172,6 +273,18 @@ bool CacheSpace::forEachCacheItem(const std::function<bool(const QSharedPointer<
     return forEachCacheItemImpl(visitor);
 }
 
+qint64 CacheSpace::memoryUsage() const
+{
+    qint64 bytes = sizeof(*this) + m_cacheItemsFactory->memoryUsage() + memoryUsageImpl();
+
+    forEachCacheItemImpl([&bytes](const QSharedPointer<CacheItem>& cacheItem)->bool {
+        bytes += cacheItem->memoryUsage();
+        return true;
+    });
+
+    return bytes;
+}
+
 bool CacheSpace::forEachCacheView(const std::function<bool(const CacheSpace::IterateInfo&)>& visitor) const
 {
     Q_ASSERT(visitor);
@@ -212,6 +325,8 @@ bool CacheSpace::forEachCacheView(const std::function<bool(const QSharedPointer<
 
 void CacheSpace::validate(const GuiContext& ctx) const
 {
+    TraceScope traceScope("CacheSpace::validate", "cache");
+
     validateItemsCache();
 
     auto_value<bool> inUse(m_cacheIsInUse, true);
@@ -235,6 +350,9 @@ void CacheSpace::draw(QPainter* painter, const GuiContext& ctx) const
 
 void CacheSpace::drawRaw(QPainter* painter, const GuiContext& ctx) const
 {
+    RenderStatsTimer timer(&RenderStats::drawTime);
+    TraceScope traceScope("CacheSpace::drawRaw", "paint");
+
     validateItemsCache();
 
     auto_value<bool> inUse(m_cacheIsInUse, true);
@@ -242,12 +360,126 @@ void CacheSpace::drawRaw(QPainter* painter, const GuiContext& ctx) const
     painter->save();
     painter->setClipRect(m_window);
 
-    forEachCacheItem([painter, &ctx, this](const QSharedPointer<CacheItem>& cacheItem)->bool {
-                         cacheItem->draw(painter, ctx, &m_window);
+    if (!drawBands(painter, ctx))
+    {
+        GridLinesBatch gridLines;
+
+        drawItems(painter, ctx, nullptr);
+
+        gridLines.draw(painter);
+    }
+
+    painter->restore();
+
+    postDrawImpl(ctx);
+}
+
+bool CacheSpace::drawBands(QPainter* painter, const GuiContext& ctx) const
+{
+    int bandsCount = qMin(m_drawThreads, m_window.height() / MinBandHeight);
+    // profiler is not thread safe
+    if (bandsCount < 2 || ViewProfiler::isEnabled())
+        return false;
+
+    // text is drawn in worker threads
+    if (!QFontDatabase::supportsThreadedFontRendering())
+        return false;
+
+    // vector devices (printer, pdf) should get vector output
+    QPaintEngine* paintEngine = painter->paintEngine();
+    if (!paintEngine || paintEngine->type() != QPaintEngine::Raster)
+        return false;
+
+    // layouts are calculated in GUI thread
+    bool isReentrant = forEachCacheItem([&ctx, this](const QSharedPointer<CacheItem>& cacheItem)->bool {
+        cacheItem->validateCacheView(ctx, &m_window);
+        return cacheItem->isDrawReentrant();
+    });
+
+    if (!isReentrant)
+        return false;
+
+    TraceScope traceScope("CacheSpace::drawBands", "paint");
+
+    qreal pixelRatio = painter->device()->devicePixelRatioF();
+    int bandHeight = (m_window.height() + bandsCount - 1) / bandsCount;
+
+    QVector<QRect> bandRects;
+    for (int top = m_window.top(); top <= m_window.bottom(); top += bandHeight)
+        bandRects.append(QRect(m_window.left(), top, m_window.width(), qMin(bandHeight, m_window.bottom() - top + 1)));
+
+    QVector<QImage> bandImages(bandRects.size());
+
+    auto drawBand = [painter, &ctx, pixelRatio, &bandRects, &bandImages, this](int band) {
+        TraceScope traceScope("CacheSpace::drawBand", "paint");
+
+        const QRect& bandRect = bandRects[band];
+        QImage& image = bandImages[band];
+        image = QImage(qCeil(bandRect.width() * pixelRatio), qCeil(bandRect.height() * pixelRatio), QImage::Format_ARGB32_Premultiplied);
+        image.setDevicePixelRatio(pixelRatio);
+        image.fill(Qt::transparent);
+
+        QPainter bandPainter(&image);
+        copyPainterState(painter, &bandPainter);
+        // map window to band coordinates
+        bandPainter.translate(-bandRect.topLeft());
+        bandPainter.setClipRect(bandRect);
+
+        GridLinesBatch gridLines;
+        drawItems(&bandPainter, ctx, &bandRect);
+        gridLines.draw(&bandPainter);
+    };
+
+    // first band is drawn by GUI thread
+    QSemaphore done;
+    for (int band = 1; band < bandRects.size(); ++band)
+        drawBandsPool()->start(new DrawBandTask([&drawBand, band]() { drawBand(band); }, done));
+
+    drawBand(0);
+    done.acquire(bandRects.size() - 1);
+
+    for (int band = 0; band < bandRects.size(); ++band)
+        painter->drawImage(bandRects[band].topLeft(), bandImages[band]);
+
+    return true;
+}
+
+void CacheSpace::drawItems(QPainter* painter, const GuiContext& ctx, const QRect* windowRect) const
+{
+    Q_ASSERT(m_cacheIsInUse);
+
+    if (!m_isDrawPassesEnabled)
+    {
+        forEachCacheItem([painter, &ctx, windowRect, this](const QSharedPointer<CacheItem>& cacheItem)->bool {
+                             if (!windowRect || cacheItem->rect.intersects(*windowRect))
+                                 cacheItem->draw(painter, ctx, &m_window);
+                             return true;
+                         });
+        return;
+    }
+
+    // validate and collect items once for all passes
+    QVector<QPair<CacheItem*, int>> items;
+    forEachCacheItem([&items, &ctx, windowRect, this](const QSharedPointer<CacheItem>& cacheItem)->bool {
+                         if (!windowRect || cacheItem->rect.intersects(*windowRect))
+                         {
+                             cacheItem->validateCacheView(ctx, &m_window);
+                             items.append(qMakePair(cacheItem.data(), cacheItem->drawPasses()));
+                         }
                          return true;
                      });
 
-    painter->restore();
+    // same kind views of all items are drawn together
+    // to reduce painter state changes
+    for (int pass = 0; pass < ViewDrawPassCount; ++pass)
+    {
+        int passMask = 1 << pass;
+        for (const auto& item : items)
+        {
+            if (item.second & passMask)
+                item.first->drawPass(painter, ctx, ViewDrawPass(pass), &m_window);
+        }
+    }
 }
 
 CacheSpaceAnimationAbstract* CacheSpace::animation() const
@@ -275,6 +507,22 @@ void CacheSpace::tryActivateControllers(const ControllerContext& context, QVecto
     cacheItem->tryActivateControllers(context, *this, &m_window, controllers);
 }
 
+bool CacheSpace::controllersHitKey(const QPoint& point, ControllersHitKey& key) const
+{
+    validateItemsCache();
+
+    const CacheItem* cacheItem = cacheItemByPosition(point);
+
+    if (!cacheItem)
+    {
+        // no controllers under the point
+        key = ControllersHitKey();
+        return true;
+    }
+
+    return cacheItem->controllersHitKey(point, key);
+}
+
 bool CacheSpace::tooltipByPoint(const QPoint& point, TooltipInfo &tooltipInfo) const
 {
     validateItemsCache();
@@ -18,18 +18,21 @@
 #define QI_CACHE_SPACE_H
 
 #include "space/Space.h"
+#include <QRegion>
 
 namespace Qi
 {
 
 class ControllerContext;
 class CacheItem;
+class ControllersHitKey;
 class CacheItemFactory;
 class CacheSpaceAnimationAbstract;
 
 class QI_EXPORT CacheSpace: public QObject
 {
     friend class CacheControllersMouse;
+    friend class CacheSpaceBackingStore;
 
     Q_OBJECT
     Q_DISABLE_COPY(CacheSpace)
@@ -45,6 +48,16 @@ public:
     ViewApplicationMask viewApplicationMask() const { return m_viewApplicationMask; }
     void setViewApplicationMask(ViewApplicationMask viewApplicationMask);
 
+    // draws views of the same pass (backgrounds, fills, texts, decorations) for all items together
+    bool isDrawPassesEnabled() const { return m_isDrawPassesEnabled; }
+    void setDrawPassesEnabled(bool enabled);
+
+    // paints window by horizontal bands in worker threads (0 or 1 - disabled)
+    // bands are used only if all drawn views are reentrant (see View::isDrawReentrant)
+    // raster painter and threaded font rendering are required too
+    int drawThreads() const { return m_drawThreads; }
+    void setDrawThreads(int threads);
+
     const QRect& window() const { return m_window; }
     void setWindow(const QRect& window);
 
@@ -55,6 +68,13 @@ public:
 
     void set(const QRect& window, const QPoint& scrollOffset);
 
+    // space coordinates used by the cache are relative to spaceOrigin
+    // it's non-zero only for spaces larger than int range
+    const SpacePoint& spaceOrigin() const { return m_spaceOrigin; }
+    // sets 64-bit scroll position, space origin follows it by big steps
+    void setScrollPosition(const SpacePoint& scrollPosition);
+    SpacePoint scrollPosition() const { return SpacePoint(m_spaceOrigin.x + m_scrollOffset.x(), m_spaceOrigin.y + m_scrollOffset.y()); }
+
     QPoint window2Space(const QPoint& windowPoint) const;
     QPoint space2Window(const QPoint& spacePoint) const;
 
@@ -72,6 +92,8 @@ public:
     void setAnimation(CacheSpaceAnimationAbstract* animation);
 
     void tryActivateControllers(const ControllerContext& context, QVector<ControllerMouse*>& controllers) const;
+    // returns false if controllers under the point cannot be identified by key
+    bool controllersHitKey(const QPoint& point, ControllersHitKey& key) const;
     bool tooltipByPoint(const QPoint& point, TooltipInfo& tooltipInfo) const;
 
     struct QI_EXPORT IterateInfo
@@ -85,12 +107,17 @@ public:
     };
 
     bool forEachCacheItem(const std::function<bool(const QSharedPointer<CacheItem>&)>& visitor) const;
+
+    // returns approximate memory used by cache items, their view trees and shared layouts in bytes
+    qint64 memoryUsage() const;
     bool forEachCacheView(const std::function<bool(const IterateInfo&)>& visitor) const;
     //bool forEachCacheView(const std::function<bool(const QSharedPointer<CacheItem>&, CacheView*)>& visitor);
 
 
 signals:
-    void cacheChanged(const CacheSpace* cache, ChangeReason reason);
+    // windowRegion - affected area in window coordinates
+    // items - absolute items which have been changed
+    void cacheChanged(const CacheSpace* cache, ChangeReason reason, const QRegion& windowRegion, const ChangedItems& items = ChangedItems());
 
 protected:
     explicit CacheSpace(const QSharedPointer<Space>& space, ViewApplicationMask viewApplicationMask = ViewApplicationDraw);
@@ -104,6 +131,10 @@ protected:
     virtual bool forEachCacheItemImpl(const std::function<bool(const QSharedPointer<CacheItem>&)>& visitor) const = 0;
     virtual const CacheItem* cacheItemImpl(const ItemID& visibleItem) const = 0;
     virtual const CacheItem* cacheItemByPositionImpl(const QPoint& point) const = 0;
+    // called after all items have been drawn
+    virtual void postDrawImpl(const GuiContext& /*ctx*/) const {}
+    // returns memory used by items not visited by forEachCacheItemImpl
+    virtual qint64 memoryUsageImpl() const { return 0; }
 
     // space
     QSharedPointer<Space> m_space;
@@ -117,6 +148,8 @@ protected:
     QRect m_window;
     // offset within frame
     QPoint m_scrollOffset;
+    // origin of the space coordinates
+    SpacePoint m_spaceOrigin;
 
     // offset delta between two ValidateItemsCache calls
     mutable QPoint m_scrollDelta;
@@ -127,12 +160,21 @@ protected:
     // flag for debugging
     mutable bool m_cacheIsInUse;
 
+    bool m_isDrawPassesEnabled;
+    int m_drawThreads;
+
     QPointer<CacheSpaceAnimationAbstract> m_animation;
 
 private:
-    void invalidateItemsCache(ChangeReason reason);
-
-    void onSpaceChanged(const Space* space, ChangeReason reason);
+    void invalidateItemsCache(ChangeReason reason, const QRegion& windowRegion);
+    // draws items intersecting windowRect or all items
+    void drawItems(QPainter* painter, const GuiContext& ctx, const QRect* windowRect) const;
+    // returns false if window cannot be drawn by bands
+    bool drawBands(QPainter* painter, const GuiContext& ctx) const;
+
+    void onSpaceChanged(const Space* space, ChangeReason reason, const ChangedItems& items);
+    // returns window area occupied by cached items
+    QRegion itemsWindowRegion(const ChangedItems& items) const;
     void updateCacheItemsFactory();
 };
 
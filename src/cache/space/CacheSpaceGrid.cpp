@@ -17,14 +17,25 @@
 #include "CacheSpaceGrid.h"
 #include "cache/CacheItem.h"
 #include "utils/auto_value.h"
+#include "utils/CallLater.h"
+#include "misc/RenderStats.h"
+#include "utils/MemoryUsage.h"
+#include <QScopedPointer>
 
 namespace Qi
 {
 
 CacheSpaceGrid::CacheSpaceGrid(const QSharedPointer<SpaceGrid>& grid, ViewApplicationMask viewApplicationMask)
     : CacheSpace(grid, viewApplicationMask),
-      m_grid(grid)
+      m_grid(grid),
+      m_prefetchRows(0),
+      m_prefetchColumns(0),
+      m_scrollVelocity(0, 0),
+      m_isPrefetchScheduled(false),
+      m_retainedItems(0),
+      m_retainBudgetUnits(CacheRetainBudgetItems)
 {
+    connect(this, &CacheSpace::cacheChanged, this, &CacheSpaceGrid::onCacheChanged);
 }
 
 CacheSpaceGrid::~CacheSpaceGrid()
@@ -72,18 +83,231 @@ ItemID CacheSpaceGrid::visibleItemByPosition(const QPoint& point) const
     QPoint gridPoint = window2Space(point);
 
     ItemID visibleItem;
-    visibleItem.row = m_grid->rows()->findVisibleIDByPos(gridPoint.y());
-    visibleItem.column = m_grid->columns()->findVisibleIDByPos(gridPoint.x());
+    visibleItem.row = m_grid->rows()->findVisibleIDByPos(m_spaceOrigin.y + gridPoint.y());
+    visibleItem.column = m_grid->columns()->findVisibleIDByPos(m_spaceOrigin.x + gridPoint.x());
 
     return visibleItem;
 }
 
+void CacheSpaceGrid::setPrefetchMargin(int rows, int columns)
+{
+    Q_ASSERT(rows >= 0 && columns >= 0);
+
+    m_prefetchRows = rows;
+    m_prefetchColumns = columns;
+
+    if (m_prefetchRows == 0 && m_prefetchColumns == 0)
+        m_prefetchItems.clear();
+}
+
+bool CacheSpaceGrid::prefetch(const GuiContext& ctx, int maxItems) const
+{
+    // wait for next paint
+    if (m_itemsCacheInvalid || m_cacheIsInUse || isEmpty())
+        return false;
+
+    auto_value<bool> inUse(m_cacheIsInUse, true);
+
+    ItemID prefetchStart, prefetchEnd;
+    prefetchRange(prefetchStart, prefetchEnd);
+
+    // visible rows go first then rows in scroll direction
+    QVector<int> rows;
+    for (int row = m_itemStart.row; row <= m_itemEnd.row; ++row)
+        rows.append(row);
+    if (m_scrollVelocity.y() >= 0)
+    {
+        for (int row = m_itemEnd.row + 1; row <= prefetchEnd.row; ++row)
+            rows.append(row);
+        for (int row = m_itemStart.row - 1; row >= prefetchStart.row; --row)
+            rows.append(row);
+    }
+    else
+    {
+        for (int row = m_itemStart.row - 1; row >= prefetchStart.row; --row)
+            rows.append(row);
+        for (int row = m_itemEnd.row + 1; row <= prefetchEnd.row; ++row)
+            rows.append(row);
+    }
+
+    for (int row : rows)
+    {
+        bool isVisibleRow = (row >= m_itemStart.row && row <= m_itemEnd.row);
+
+        for (ItemID visibleItem(row, prefetchStart.column); visibleItem.column <= prefetchEnd.column; ++visibleItem.column)
+        {
+            // visible items are validated by paint
+            if (isVisibleRow && visibleItem.column >= m_itemStart.column && visibleItem.column <= m_itemEnd.column)
+                continue;
+
+            if (m_prefetchItems.contains(visibleItem))
+                continue;
+
+            if (maxItems-- <= 0)
+                return true;
+
+            // keep item in space coordinates
+            auto cacheItem = createCacheItem(visibleItem);
+            cacheItem->validateCacheView(ctx);
+            m_prefetchItems.insert(visibleItem, cacheItem);
+        }
+    }
+
+    return false;
+}
+
+void CacheSpaceGrid::prefetchRange(ItemID& itemStart, ItemID& itemEnd) const
+{
+    int rowsBefore = m_prefetchRows;
+    int rowsAfter = m_prefetchRows;
+    int columnsBefore = m_prefetchColumns;
+    int columnsAfter = m_prefetchColumns;
+
+    // extend margin in scroll direction proportionally to scroll speed
+    int rowsSpeed = qMin(qAbs(m_scrollVelocity.y()), m_prefetchRows * 4);
+    if (m_scrollVelocity.y() > 0)
+    {
+        rowsAfter += rowsSpeed;
+        rowsBefore /= 2;
+    }
+    else if (m_scrollVelocity.y() < 0)
+    {
+        rowsBefore += rowsSpeed;
+        rowsAfter /= 2;
+    }
+
+    int columnsSpeed = qMin(qAbs(m_scrollVelocity.x()), m_prefetchColumns * 4);
+    if (m_scrollVelocity.x() > 0)
+    {
+        columnsAfter += columnsSpeed;
+        columnsBefore /= 2;
+    }
+    else if (m_scrollVelocity.x() < 0)
+    {
+        columnsBefore += columnsSpeed;
+        columnsAfter /= 2;
+    }
+
+    itemStart.row = qMax(0, m_itemStart.row - rowsBefore);
+    itemStart.column = qMax(0, m_itemStart.column - columnsBefore);
+    itemEnd.row = qMin(m_grid->rows()->visibleCount() - 1, m_itemEnd.row + rowsAfter);
+    itemEnd.column = qMin(m_grid->columns()->visibleCount() - 1, m_itemEnd.column + columnsAfter);
+}
+
+void CacheSpaceGrid::schedulePrefetch(const QWidget* widget) const
+{
+    if (m_isPrefetchScheduled)
+        return;
+
+    m_isPrefetchScheduled = true;
+
+    QPointer<QWidget> widgetPtr(const_cast<QWidget*>(widget));
+    callLater(const_cast<CacheSpaceGrid*>(this), [this, widgetPtr]() {
+        m_isPrefetchScheduled = false;
+        if (widgetPtr.isNull())
+            return;
+
+        // continue in next idle time if not finished
+        if (prefetch(GuiContext(widgetPtr.data())))
+            schedulePrefetch(widgetPtr.data());
+    });
+}
+
+void CacheSpaceGrid::setRetainBudget(int budget, CacheRetainBudget units)
+{
+    Q_ASSERT(budget >= 0);
+
+    if (m_retainBudgetUnits != units)
+    {
+        // costs are not comparable
+        m_retainedItems.clear();
+        m_retainBudgetUnits = units;
+    }
+
+    m_retainedItems.setMaxCost(budget);
+}
+
+void CacheSpaceGrid::retainItem(const QSharedPointer<CacheItem>& cacheItem) const
+{
+    int cost = (m_retainBudgetUnits == CacheRetainBudgetBytes) ? int(cacheItem->memoryUsage()) : 1;
+    m_retainedItems.insert(cacheItem->item, new QSharedPointer<CacheItem>(cacheItem), cost);
+}
+
+QSharedPointer<CacheItem> CacheSpaceGrid::takeRetainedItem(const ItemID& visibleItem) const
+{
+    if (m_retainedItems.isEmpty())
+        return QSharedPointer<CacheItem>();
+
+    QScopedPointer<QSharedPointer<CacheItem>> cacheItem(m_retainedItems.take(m_grid->toAbsolute(visibleItem)));
+    if (!cacheItem)
+        return QSharedPointer<CacheItem>();
+
+    // item has been moved within space
+    if ((*cacheItem)->rect != m_grid->localItemRect(visibleItem, m_spaceOrigin))
+        return QSharedPointer<CacheItem>();
+
+    return *cacheItem;
+}
+
+void CacheSpaceGrid::onCacheChanged(const CacheSpace* cache, ChangeReason reason, const QRegion& /*windowRegion*/, const ChangedItems& items)
+{
+    Q_UNUSED(cache);
+    Q_ASSERT(cache == this);
+
+    // items schemas have been changed
+    if ((reason & ChangeReasonCacheItems) && !(reason & ChangeReasonCacheFrame))
+    {
+        m_prefetchItems.clear();
+        m_retainedItems.clear();
+    }
+    else if (reason & ChangeReasonCacheContent)
+    {
+        // relayout changed retained items on demand
+        for (const auto& item: m_retainedItems.keys())
+        {
+            if (items.hasItem(item))
+                (*m_retainedItems.object(item))->invalidateCacheView();
+        }
+
+        // prefetched items are keyed by visible item but changed items are absolute
+        for (const auto& cacheItem: m_prefetchItems)
+        {
+            if (items.hasItem(cacheItem->item))
+                cacheItem->invalidateCacheView();
+        }
+    }
+}
+
+void CacheSpaceGrid::postDrawImpl(const GuiContext& ctx) const
+{
+    if (m_prefetchRows == 0 && m_prefetchColumns == 0)
+        return;
+
+    schedulePrefetch(ctx.widget);
+}
+
+qint64 CacheSpaceGrid::memoryUsageImpl() const
+{
+    qint64 bytes = containerMemory(m_items) + containerMemory(m_prefetchItems);
+
+    for (const auto& cacheItem: m_prefetchItems)
+        bytes += cacheItem->memoryUsage();
+
+    for (const auto& item: m_retainedItems.keys())
+        bytes += (*m_retainedItems.object(item))->memoryUsage();
+
+    return bytes;
+}
+
 void CacheSpaceGrid::clearItemsCacheImpl() const
 {
     Q_ASSERT(!m_cacheIsInUse);
 
     m_itemStart = m_itemEnd = ItemID();
     m_items.clear();
+    m_prefetchItems.clear();
+    m_retainedItems.clear();
+    m_scrollVelocity = QPoint(0, 0);
     m_scrollDelta = QPoint(0, 0);
     m_sizeDelta = QSize(0, 0);
 }
@@ -104,10 +328,11 @@ void CacheSpaceGrid::validateItemsCacheImpl() const
     const Lines& rows = *m_grid->rows();
     const Lines& columns = *m_grid->columns();
 
-    int visibleRowStart = rows.findVisibleIDByPos(m_scrollOffset.y());
-    int visibleRowEnd = rows.findVisibleIDByPos(m_scrollOffset.y() + m_window.height());
-    int visibleColumnStart = columns.findVisibleIDByPos(m_scrollOffset.x());
-    int visibleColumnEnd = columns.findVisibleIDByPos(m_scrollOffset.x() + m_window.width());
+    SpacePoint scrollPos = scrollPosition();
+    int visibleRowStart = rows.findVisibleIDByPos(scrollPos.y);
+    int visibleRowEnd = rows.findVisibleIDByPos(scrollPos.y + m_window.height());
+    int visibleColumnStart = columns.findVisibleIDByPos(scrollPos.x);
+    int visibleColumnEnd = columns.findVisibleIDByPos(scrollPos.x + m_window.width());
 
     Q_ASSERT(visibleRowStart != InvalidIndex);
     Q_ASSERT(visibleRowEnd != InvalidIndex);
@@ -136,6 +361,8 @@ void CacheSpaceGrid::validateItemsCacheImpl() const
     int newItemColumns = newItemEnd.column - newItemStart.column + 1;
     QVector<QSharedPointer<CacheItem>> newItems(newItemRows * newItemColumns, QSharedPointer<CacheItem>());
 
+    QPoint origin = originPos();
+
     if (!m_items.isEmpty())
     {
         // find intersection between old and new items
@@ -154,10 +381,26 @@ void CacheSpaceGrid::validateItemsCacheImpl() const
                 newCacheItem.swap(oldCacheItem);
                 newCacheItem->correctRectangles(m_scrollDelta);
             }
+
+        RenderStats::count(&RenderStats::itemsReused, qMax(0, intersectionEnd.row - intersectionStart.row + 1) * qMax(0, intersectionEnd.column - intersectionStart.column + 1));
+
+        // retain items leaving the frame
+        if (m_retainedItems.maxCost() > 0)
+        {
+            QPoint oldOrigin = origin - m_scrollDelta;
+            for (const auto& cacheItem: m_items)
+            {
+                if (!cacheItem)
+                    continue;
+
+                // move to space coordinates
+                cacheItem->correctRectangles(-oldOrigin);
+                retainItem(cacheItem);
+            }
+        }
     }
 
     // initialize non-intersected cells
-    QPoint origin = originPos();
     for (ItemID itemVisible = newItemStart; itemVisible.column <= newItemEnd.column; ++itemVisible.column)
     {
         for (itemVisible.row = newItemStart.row; itemVisible.row <= newItemEnd.row; ++itemVisible.row)
@@ -168,16 +411,49 @@ void CacheSpaceGrid::validateItemsCacheImpl() const
             if (cacheItem)
                 continue;
 
+            // take prepared item if any
+            cacheItem = m_prefetchItems.take(itemVisible);
+            if (!cacheItem)
+                cacheItem = takeRetainedItem(itemVisible);
+
+            if (cacheItem)
+            {
+                RenderStats::count(&RenderStats::itemsReused);
+                cacheItem->correctRectangles(origin);
+                continue;
+            }
+
             cacheItem = createCacheItem(itemVisible);
             // correct rectangle
             cacheItem->rect.translate(origin);
         }
     }
 
+    // remember scroll direction and speed in lines
+    if (m_itemStart.isValid())
+        m_scrollVelocity = QPoint(newItemStart.column - m_itemStart.column, newItemStart.row - m_itemStart.row);
+
     m_itemStart.swap(newItemStart);
     m_itemEnd.swap(newItemEnd);
     m_items.swap(newItems);
 
+    // drop prepared items which are too far from visible items
+    if (!m_prefetchItems.isEmpty())
+    {
+        ItemID prefetchStart, prefetchEnd;
+        prefetchRange(prefetchStart, prefetchEnd);
+
+        for (auto it = m_prefetchItems.begin(); it != m_prefetchItems.end(); )
+        {
+            const ItemID& item = it.key();
+            if (item.row < prefetchStart.row || item.row > prefetchEnd.row ||
+                item.column < prefetchStart.column || item.column > prefetchEnd.column)
+                it = m_prefetchItems.erase(it);
+            else
+                ++it;
+        }
+    }
+
     // clear offset
     m_scrollDelta = QPoint(0, 0);
     m_sizeDelta = QSize(0, 0);
@@ -217,8 +493,8 @@ const CacheItem* CacheSpaceGrid::cacheItemByPositionImpl(const QPoint& point) co
     QPoint gridPoint = window2Space(point);
 
     ItemID visibleItem;
-    visibleItem.row = m_grid->rows()->findVisibleIDByPos(gridPoint.y(), m_itemStart.row, m_itemEnd.row);
-    visibleItem.column = m_grid->columns()->findVisibleIDByPos(gridPoint.x(), m_itemStart.column, m_itemEnd.column);
+    visibleItem.row = m_grid->rows()->findVisibleIDByPos(m_spaceOrigin.y + gridPoint.y(), m_itemStart.row, m_itemEnd.row);
+    visibleItem.column = m_grid->columns()->findVisibleIDByPos(m_spaceOrigin.x + gridPoint.x(), m_itemStart.column, m_itemEnd.column);
 
     return cacheItem(visibleItem);
 }
@@ -19,10 +19,18 @@
 
 #include "CacheSpace.h"
 #include "space/SpaceGrid.h"
+#include <QHash>
+#include <QCache>
 
 namespace Qi
 {
 
+enum CacheRetainBudget
+{
+    CacheRetainBudgetItems,
+    CacheRetainBudgetBytes
+};
+
 class QI_EXPORT CacheSpaceGrid: public CacheSpace
 {
     Q_OBJECT
@@ -42,13 +50,37 @@ public:
     void visibleItemsRange(ItemID& itemStart, ItemID& itemEnd) const;
     ItemID visibleItemByPosition(const QPoint& point) const;
 
+    // number of rows and columns prepared around visible items in idle time
+    int prefetchRows() const { return m_prefetchRows; }
+    int prefetchColumns() const { return m_prefetchColumns; }
+    void setPrefetchMargin(int rows, int columns);
+
+    // creates and validates up to maxItems items around visible items
+    // returns true if more items are left to prefetch
+    bool prefetch(const GuiContext& ctx, int maxItems = 64) const;
+
+    // keeps recently scrolled away items (0 - disabled)
+    int retainBudget() const { return m_retainedItems.maxCost(); }
+    CacheRetainBudget retainBudgetUnits() const { return m_retainBudgetUnits; }
+    void setRetainBudget(int budget, CacheRetainBudget units = CacheRetainBudgetItems);
+
 private:
+    void onCacheChanged(const CacheSpace* cache, ChangeReason reason, const QRegion& windowRegion, const ChangedItems& items);
+
+    void postDrawImpl(const GuiContext& ctx) const override;
+    qint64 memoryUsageImpl() const override;
     void clearItemsCacheImpl() const override;
     void validateItemsCacheImpl() const override;
     bool forEachCacheItemImpl(const std::function<bool(const QSharedPointer<CacheItem>&)>& visitor) const override;
     const CacheItem* cacheItemImpl(const ItemID& visibleItem) const override;
     const CacheItem* cacheItemByPositionImpl(const QPoint& point) const override;
 
+    void prefetchRange(ItemID& itemStart, ItemID& itemEnd) const;
+    void schedulePrefetch(const QWidget* widget) const;
+
+    void retainItem(const QSharedPointer<CacheItem>& cacheItem) const;
+    QSharedPointer<CacheItem> takeRetainedItem(const ItemID& visibleItem) const;
+
     // source grid space
     QSharedPointer<SpaceGrid> m_grid;
 
@@ -57,6 +89,19 @@ private:
     mutable ItemID m_itemEnd;
     // caches items
     mutable QVector<QSharedPointer<CacheItem>> m_items;
+
+    // prefetch margin
+    int m_prefetchRows;
+    int m_prefetchColumns;
+    // visible lines passed by last scroll
+    mutable QPoint m_scrollVelocity;
+    // prepared items outside visible items (in space coordinates)
+    mutable QHash<ItemID, QSharedPointer<CacheItem>> m_prefetchItems;
+    mutable bool m_isPrefetchScheduled;
+
+    // recently scrolled away items by absolute id (in space coordinates)
+    mutable QCache<ItemID, QSharedPointer<CacheItem>> m_retainedItems;
+    CacheRetainBudget m_retainBudgetUnits;
 };
 
 } // end namespace Qi 
@@ -17,6 +17,7 @@
 #include "CacheSpaceScene.h"
 #include "cache/CacheItem.h"
 #include "utils/auto_value.h"
+#include <algorithm>
 
 namespace Qi
 {
@@ -53,19 +54,17 @@ void CacheSpaceScene::validateItemsCacheImpl() const
 
     auto_value<bool> inUse(m_cacheIsInUse, true);
 
-    QRect cacheRect(scrollOffset(), window().size());
+    // visible part of the scene
+    QRect sceneRect = QRect(scrollOffset(), window().size()).translated(int(spaceOrigin().x), int(spaceOrigin().y));
     QPoint origin = originPos();
 
-    int count = m_scene->count();
     auto it = m_items.begin();
 
     QVector<QSharedPointer<CacheItem>> newItems;
 
-    for (ItemID item(0, 0); item.column < count; ++item.column)
+    // items are found in ascending order
+    for (const ItemID& item: m_scene->itemsInRect(sceneRect))
     {
-        if (!cacheRect.intersects(m_scene->itemRect(item)))
-            continue;
-
         QSharedPointer<CacheItem> newItem;
         while ((it != m_items.end()) && ((*it)->item.column <= item.column))
         {
@@ -110,11 +109,13 @@ bool CacheSpaceScene::forEachCacheItemImpl(const std::function<bool(const QShare
 
 const CacheItem* CacheSpaceScene::cacheItemImpl(const ItemID& visibleItem) const
 {
-    for (const auto& cacheItem : m_items)
-    {
-        if (cacheItem->item == visibleItem)
-            return cacheItem.data();
-    }
+    // items are sorted by column
+    auto it = std::lower_bound(m_items.cbegin(), m_items.cend(), visibleItem.column, [](const QSharedPointer<CacheItem>& cacheItem, int column) {
+        return cacheItem->item.column < column;
+    });
+
+    if (it != m_items.cend() && (*it)->item == visibleItem)
+        return it->data();
 
     return nullptr;
 }
@@ -126,10 +127,11 @@ const CacheItem* CacheSpaceScene::cacheItemByPositionImpl(const QPoint& point) c
     if (isEmpty())
         return nullptr;
 
-    for (const auto& cacheItem : m_items)
+    QPoint scenePoint = point - originPos() + QPoint(int(spaceOrigin().x), int(spaceOrigin().y));
+    for (const ItemID& item: m_scene->itemsAtPoint(scenePoint))
     {
-        if (cacheItem->rect.contains(point))
-            return cacheItem.data();
+        if (const CacheItem* cacheItem = cacheItemImpl(item))
+            return cacheItem;
     }
 
     return nullptr;
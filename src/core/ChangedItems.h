@@ -0,0 +1,88 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef QI_CHANGED_ITEMS_H
+#define QI_CHANGED_ITEMS_H
+
+#include "ItemID.h"
+#include <limits>
+
+namespace Qi
+{
+
+// describes absolute items affected by a change
+// as a rectangle of rows and columns
+class QI_EXPORT ChangedItems
+{
+public:
+    // all items have been changed
+    ChangedItems()
+        : m_start(0, 0), m_end(MaxIndex, MaxIndex)
+    {}
+
+    // single item has been changed
+    explicit ChangedItems(const ItemID& item)
+        : m_start(item), m_end(item)
+    { Q_ASSERT(item.isValid()); }
+
+    // items from start to end (inclusive) have been changed
+    ChangedItems(const ItemID& start, const ItemID& end)
+        : m_start(start), m_end(end)
+    {
+        Q_ASSERT(start.isValid() && end.isValid());
+        Q_ASSERT(start.row <= end.row && start.column <= end.column);
+    }
+
+    // rows span in all columns
+    static ChangedItems rows(int rowStart, int rowEnd) { return ChangedItems(ItemID(rowStart, 0), ItemID(rowEnd, MaxIndex)); }
+    // columns span in all rows
+    static ChangedItems columns(int columnStart, int columnEnd) { return ChangedItems(ItemID(0, columnStart), ItemID(MaxIndex, columnEnd)); }
+
+    const ItemID& start() const { return m_start; }
+    const ItemID& end() const { return m_end; }
+
+    bool isAll() const { return m_start == ItemID(0, 0) && m_end == ItemID(MaxIndex, MaxIndex); }
+    bool isSingle() const { return m_start == m_end; }
+
+    bool hasItem(const ItemID& item) const
+    {
+        return (item.row >= m_start.row) && (item.row <= m_end.row) &&
+               (item.column >= m_start.column) && (item.column <= m_end.column);
+    }
+
+    bool intersects(const ChangedItems& other) const
+    {
+        return (m_start.row <= other.m_end.row) && (other.m_start.row <= m_end.row) &&
+               (m_start.column <= other.m_end.column) && (other.m_start.column <= m_end.column);
+    }
+
+    // returns bounding rectangle of both changes
+    ChangedItems united(const ChangedItems& other) const
+    {
+        return ChangedItems(ItemID(qMin(m_start.row, other.m_start.row), qMin(m_start.column, other.m_start.column)),
+                            ItemID(qMax(m_end.row, other.m_end.row), qMax(m_end.column, other.m_end.column)));
+    }
+
+private:
+    static const int MaxIndex = std::numeric_limits<int>::max();
+
+    ItemID m_start;
+    ItemID m_end;
+};
+
+} // end namespace Qi
+
+#endif // QI_CHANGED_ITEMS_H
@@ -58,6 +58,10 @@ public:
     virtual bool processMouseMove(QMouseEvent* /*event*/) { return false; }
     virtual bool processContextMenu(QContextMenuEvent* /*event*/) { return false; }
 
+    // controller accepts activation depending on exact point within the view
+    // otherwise activation stays the same while mouse moves within the view
+    bool isActivationPointSensitive() const { return isActivationPointSensitiveImpl(); }
+
     bool acceptInplaceEdit(const ItemID& item, const CacheSpace& cacheSpace, const QKeyEvent* keyEvent = nullptr) const;
     void doInplaceEdit(QVector<ControllerMouse*>& activatedControllers, const ControllerContext& context, const CacheContext& cache, const CacheSpace& cacheSpace, const QKeyEvent* keyEvent = nullptr);
     void updateInplaceEditLayout();
@@ -116,6 +120,9 @@ protected:
 
     virtual void tryActivateImpl(QVector<ControllerMouse*>& activatedControllers, const ActivationInfo& activationInfo);
     virtual bool acceptImpl(const ActivationInfo& /*activationInfo*/) const { return true; }
+    // return true if acceptImpl or activateImpl reads activationInfo.context.point
+    // (reading the live point later through activationState() is fine)
+    virtual bool isActivationPointSensitiveImpl() const { return false; }
     virtual void activateImpl(const ActivationInfo& activationInfo);
     virtual bool needDeactivateImpl(const ActivationInfo& activationInfo) const;
     virtual void deactivateImpl();
@@ -18,6 +18,7 @@
 #define QI_MODEL_H
 
 #include "ItemID.h"
+#include "ChangedItems.h"
 
 namespace Qi
 {
@@ -32,9 +33,16 @@ protected:
 
 public:
     virtual ~Model();
-    
+
+    // returns approximate memory used by the model in bytes
+    qint64 memoryUsage() const { return memoryUsageImpl(); }
+
 signals:
-    void modelChanged(const Model*);
+    // items - absolute items which have been changed
+    void modelChanged(const Model* model, const ChangedItems& items = ChangedItems());
+
+protected:
+    virtual qint64 memoryUsageImpl() const { return sizeof(Model); }
 };
 
 class QI_EXPORT ModelComparable: public Model
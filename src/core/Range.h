@@ -38,6 +38,15 @@ public:
     bool hasRow(int row) const { return hasRowImpl(row); }
     bool hasColumn(int column) const { return hasColumnImpl(column); }
 
+    // returns false if the range has no items in the row or column
+    // unlike hasRow and hasColumn it is true for ranges of other lines
+    // (columns range touches every row)
+    bool touchesRow(int row) const { return touchesRowImpl(row); }
+    bool touchesColumn(int column) const { return touchesColumnImpl(column); }
+
+    // returns approximate memory used by the range in bytes
+    qint64 memoryUsage() const { return memoryUsageImpl(); }
+
 signals:
     void rangeChanged(const Range*, ChangeReason);
 
@@ -48,6 +57,12 @@ protected:
     virtual bool hasRowImpl(int row) const = 0;
     // should return true if column intersets with the range and false otherwise
     virtual bool hasColumnImpl(int column) const = 0;
+    // should return false only if no items of the row are in the range
+    virtual bool touchesRowImpl(int /*row*/) const { return true; }
+    // should return false only if no items of the column are in the range
+    virtual bool touchesColumnImpl(int /*column*/) const { return true; }
+    // should return memory used by the range
+    virtual qint64 memoryUsageImpl() const { return sizeof(Range); }
 };
 
 } // end namespace Qi
@@ -18,6 +18,7 @@
 #include "Layout.h"
 #include "core/ext/ControllerMouseMultiple.h"
 #include "core/ext/ControllerMousePushable.h"
+#include "misc/ViewProfiler.h"
 
 namespace Qi
 {
@@ -60,10 +61,24 @@ void View::addController(QSharedPointer<ControllerMouse> controller)
     }
 }
 
+CacheView* View::addCacheView(const Layout& layout, const GuiContext& ctx, const ItemID& item, QVector<CacheView>& cacheViews, QRect& itemRect, QRect* visibleItemRect) const
+{
+    ViewProfilerScope profilerScope(this, ViewProfiler::OperationLayout);
+    return addCacheViewImpl(layout, ctx, item, cacheViews, itemRect, visibleItemRect);
+}
+
+QSize View::size(const GuiContext& ctx, const ItemID& item, ViewSizeMode sizeMode) const
+{
+    ViewProfilerScope profilerScope(this, ViewProfiler::OperationSize);
+    return sizeImpl(ctx, item, sizeMode);
+}
+
 void View::draw(QPainter* painter, const GuiContext& ctx, const CacheContext& cache, bool* showTooltip) const
 {
     Q_ASSERT(cache.cacheView.view() == this);
 
+    ViewProfilerScope profilerScope(this, ViewProfiler::OperationDraw);
+
     drawImpl(painter, ctx, cache, showTooltip);
 
     if (showTooltip && tooltipTextCallback)
@@ -78,9 +93,9 @@ bool View::tooltipText(const ItemID& item, QString& text) const
     return tooltipTextImpl(item, text);
 }
 
-void View::emitViewChanged(ChangeReason reason)
+void View::emitViewChanged(ChangeReason reason, const ChangedItems& items)
 {
-    emit viewChanged(this, reason);
+    emit viewChanged(this, reason, items);
 }
 
 void View::addViewImpl(const ItemID& /*item*/, QVector<const View*>& views) const
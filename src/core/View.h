@@ -19,6 +19,7 @@
 
 #include "core/misc/ViewAuxiliary.h"
 #include "cache/CacheView.h"
+#include "core/ChangedItems.h"
 #include <QPainter>
 #include <functional>
 
@@ -54,18 +55,33 @@ public:
     { addViewImpl(item, views); }
 
     // adds self CacheView to cacheViews
-    CacheView* addCacheView(const Layout& layout, const GuiContext& ctx, const ItemID& item, QVector<CacheView>& cacheViews, QRect& itemRect, QRect* visibleItemRect) const
-    { return addCacheViewImpl(layout, ctx, item, cacheViews, itemRect, visibleItemRect); }
+    CacheView* addCacheView(const Layout& layout, const GuiContext& ctx, const ItemID& item, QVector<CacheView>& cacheViews, QRect& itemRect, QRect* visibleItemRect) const;
 
     // returns size of the view
-    QSize size(const GuiContext& ctx, const ItemID& item, ViewSizeMode sizeMode) const
-    { return sizeImpl(ctx, item, sizeMode); }
+    QSize size(const GuiContext& ctx, const ItemID& item, ViewSizeMode sizeMode) const;
+
+    // returns key of the item state which affects view layout
+    // items with equal keys share layout, so key should be exact (no hashes)
+    // returns false if view layout cannot be shared between items
+    bool layoutKey(const ItemID& item, QString& key) const
+    { return layoutKeyImpl(item, key); }
 
     // draws view content
     void draw(QPainter* painter, const GuiContext& ctx, const CacheContext& cache, bool* showTooltip) const;
     // restores painter state after draw
     void cleanupDraw(QPainter* painter, const GuiContext& ctx, const CacheContext& cache) const
     { cleanupDrawImpl(painter, ctx, cache); }
+    // returns painting pass of the view
+    ViewDrawPass drawPass() const { return drawPassImpl(); }
+    // sets painter state used by following views without painting
+    // called instead of draw in passes of other views
+    void drawState(QPainter* painter, const GuiContext& ctx, const CacheContext& cache) const
+    { drawStateImpl(painter, ctx, cache); }
+    // returns true if draw may run in worker threads (see CacheSpace::setDrawThreads)
+    // GUI thread waits for the workers, so reentrant view may read its model and widget
+    // but it shouldn't change own members, use QPixmap or QStyle during draw
+    // models and callbacks read by reentrant views should allow concurrent reads
+    bool isDrawReentrant() const { return isDrawReentrantImpl(); }
 
     // returns text representation of the view
     bool text(const ItemID& item, QString& txt) const { return textImpl(item, txt); }
@@ -79,10 +95,11 @@ public:
     Model* model() { return modelImpl(); }
 
     // emits viewChanged signal
-    void emitViewChanged(ChangeReason reason);
+    void emitViewChanged(ChangeReason reason, const ChangedItems& items = ChangedItems());
 
 signals:
-    void viewChanged(const View*, ChangeReason);
+    // items - absolute items which have been changed
+    void viewChanged(const View* view, ChangeReason reason, const ChangedItems& items = ChangedItems());
 
 protected:
     // adds View to views
@@ -91,10 +108,19 @@ protected:
     virtual CacheView* addCacheViewImpl(const Layout& layout, const GuiContext& ctx, const ItemID& item, QVector<CacheView>& cacheViews, QRect& itemRect, QRect* visibleItemRect) const;
     // returns size of the view
     virtual QSize sizeImpl(const GuiContext& /*ctx*/, const ItemID& /*item*/, ViewSizeMode /*sizeMode*/) const;
+    // returns key of the layout affecting state
+    virtual bool layoutKeyImpl(const ItemID& /*item*/, QString& /*key*/) const { return false; }
     // draws view content
     virtual void drawImpl(QPainter* /*painter*/, const GuiContext& /*ctx*/, const CacheContext& /*cache*/, bool* /*showTooltip*/) const { }
     // cleanups drawing attributes
     virtual void cleanupDrawImpl(QPainter* /*painter*/, const GuiContext& /*ctx*/, const CacheContext& /*cache*/) const { }
+    // returns painting pass
+    virtual ViewDrawPass drawPassImpl() const { return ViewDrawPassFill; }
+    // sets drawing attributes, views with cleanupDrawImpl should implement it
+    virtual void drawStateImpl(QPainter* /*painter*/, const GuiContext& /*ctx*/, const CacheContext& /*cache*/) const { }
+    // returns true if draw is reentrant
+    // subclasses of reentrant views inherit it and should override if they add state
+    virtual bool isDrawReentrantImpl() const { return false; }
 
     // returns text representation of the view
     virtual bool textImpl(const ItemID& /*item*/, QString& /*txt*/) const { return false; }
@@ -38,6 +38,17 @@ void ControllerMouseMultiple::tryActivateImpl(QVector<ControllerMouse*>& activat
     }
 }
 
+bool ControllerMouseMultiple::isActivationPointSensitiveImpl() const
+{
+    for (const auto& controller: m_controllers)
+    {
+        if (controller->isActivationPointSensitive())
+            return true;
+    }
+
+    return false;
+}
+
 void ControllerMouseMultiple::activateImpl(const ActivationInfo& activationInfo)
 {
     // should never be happened
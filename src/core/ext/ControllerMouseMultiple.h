@@ -41,6 +41,7 @@ protected:
     void tryActivateImpl(QVector<ControllerMouse*>& activatedControllers, const ActivationInfo& activationInfo) override;
     void activateImpl(const ActivationInfo& activationInfo) override;
     void deactivateImpl() override;
+    bool isActivationPointSensitiveImpl() const override;
 
 private:
     QVector<QSharedPointer<ControllerMouse>> m_controllers;
@@ -19,6 +19,8 @@
 
 #include "ModelTyped.h"
 #include "space/SpaceGrid.h"
+#include "utils/MemoryUsage.h"
+#include "utils/VectorEdit.h"
 #include <QSet>
 #include <functional>
 
@@ -37,15 +39,23 @@ public:
         m_connection = QObject::connect(grid.data(), &Space::spaceChanged, [this] (const Space* space, ChangeReason reason) {
             onSpaceChanged(space, reason);
         });
+        m_linesConnections.append(QObject::connect(grid->rows().data(), &Lines::linesRemoved, this, &ModelStorageGrid::onRowsRemoved));
+        m_linesConnections.append(QObject::connect(grid->rows().data(), &Lines::linesInserted, this, &ModelStorageGrid::onRowsInserted));
+        m_linesConnections.append(QObject::connect(grid->columns().data(), &Lines::linesRemoved, this, &ModelStorageGrid::onColumnsRemoved));
+        m_linesConnections.append(QObject::connect(grid->columns().data(), &Lines::linesInserted, this, &ModelStorageGrid::onColumnsInserted));
         resize();
     }
 
     ~ModelStorageGrid()
     {
         QObject::disconnect(m_connection);
+        for (const auto& connection: m_linesConnections)
+            QObject::disconnect(connection);
     }
 
 protected:
+    qint64 memoryUsageImpl() const override { return sizeof(*this) + containerMemory(m_values); }
+
     T valueImpl(const ItemID& item) const override
     {
         int index = item.column * m_rowsCount + item.row;
@@ -55,6 +65,8 @@ protected:
         return m_values[index];
     }
 
+    ChangedItems changedItemsImpl(const ItemID& item) const override { return ChangedItems(item); }
+
     bool setValueImpl(const ItemID& item, T value) override
     {
         int index = item.column * m_rowsCount + item.row;
@@ -81,6 +93,41 @@ private slots:
         }
     }
 
+    // values are stored by columns, so rows are removed from every column
+    void onRowsRemoved(const Lines* /*rows*/, const QVector<int>& rows)
+    {
+        removeValues(m_values, rows, m_rowsCount);
+        m_rowsCount -= rows.size();
+        emit this->modelChanged(this);
+    }
+
+    void onRowsInserted(const Lines* /*rows*/, int rowBefore, int rowsCount)
+    {
+        insertValues(m_values, rowBefore, rowsCount, StorageT(), m_rowsCount);
+        m_rowsCount += rowsCount;
+        emit this->modelChanged(this);
+    }
+
+    void onColumnsRemoved(const Lines* /*columns*/, const QVector<int>& columns)
+    {
+        QVector<int> indices;
+        indices.reserve(columns.size() * m_rowsCount);
+        for (int column: columns)
+        {
+            for (int row = 0; row < m_rowsCount; ++row)
+                indices.append(column * m_rowsCount + row);
+        }
+
+        removeValues(m_values, indices);
+        emit this->modelChanged(this);
+    }
+
+    void onColumnsInserted(const Lines* /*columns*/, int columnBefore, int columnsCount)
+    {
+        insertValues(m_values, columnBefore * m_rowsCount, columnsCount * m_rowsCount);
+        emit this->modelChanged(this);
+    }
+
 private:
     void resize()
     {
@@ -93,6 +140,7 @@ private:
     QVector<StorageT> m_values;
     int m_rowsCount;
     QMetaObject::Connection m_connection;
+    QVector<QMetaObject::Connection> m_linesConnections;
 };
 
 template <typename T, typename StorageT = typename std::decay<T>::type, typename NotEq = typename std::not_equal_to<T>>
@@ -105,6 +153,8 @@ public:
     }
 
 protected:
+    qint64 memoryUsageImpl() const override { return sizeof(*this); }
+
     T valueImpl(const ItemID& /*item*/) const override
     {
         return m_value;
@@ -138,10 +188,16 @@ public:
     {
         auto rows = m_rows.toStrongRef();
         if (rows)
+        {
             disconnect(rows.data(), &Lines::linesChanged, this, &ModelStorageColumns::onRowsChanged);
+            disconnect(rows.data(), &Lines::linesRemoved, this, &ModelStorageColumns::onRowsRemoved);
+            disconnect(rows.data(), &Lines::linesInserted, this, &ModelStorageColumns::onRowsInserted);
+        }
     }
 
 protected:
+    qint64 memoryUsageImpl() const override { return sizeof(*this) + containerMemory(m_values) + valuesMemory(); }
+
     T valueImpl(const ItemID& item) const override
     {
         auto it = m_values.find(item.column);
@@ -152,6 +208,8 @@ protected:
         return (*it).value()[item.row];
     }
 
+    ChangedItems changedItemsImpl(const ItemID& item) const override { return ChangedItems(item); }
+
     bool setValueImpl(const ItemID& item, T value) override
     {
         auto it = m_values.find(item.column);
@@ -176,7 +234,28 @@ private slots:
         }
     }
 
+    void onRowsRemoved(const Lines* /*rows*/, const QVector<int>& rows)
+    {
+        for (auto& values: m_values)
+            removeValues(values, rows);
+        emit this->modelChanged(this);
+    }
+
+    void onRowsInserted(const Lines* /*rows*/, int rowBefore, int rowsCount)
+    {
+        for (auto& values: m_values)
+            insertValues(values, rowBefore, rowsCount);
+        emit this->modelChanged(this);
+    }
+
 private:
+    void connectRows(const QSharedPointer<Lines>& rows)
+    {
+        connect(rows.data(), &Lines::linesChanged, this, &ModelStorageColumns::onRowsChanged);
+        connect(rows.data(), &Lines::linesRemoved, this, &ModelStorageColumns::onRowsRemoved);
+        connect(rows.data(), &Lines::linesInserted, this, &ModelStorageColumns::onRowsInserted);
+    }
+
     void init(const QSharedPointer<Lines>& rows, const QSet<int>& columns)
     {
         m_rows = rows;
@@ -187,7 +266,7 @@ private:
             m_values[column] = emptyValues;
         }
 
-        connect(rows.data(), &Lines::linesChanged, this, &ModelStorageColumns::onRowsChanged);
+        connectRows(rows);
         resize();
     }
 
@@ -201,10 +280,18 @@ private:
             m_values[column] = emptyValues;
         }
 
-        connect(rows.data(), &Lines::linesChanged, this, &ModelStorageColumns::onRowsChanged);
+        connectRows(rows);
         resize();
     }
 
+    qint64 valuesMemory() const
+    {
+        qint64 bytes = 0;
+        for (const auto& values: m_values)
+            bytes += containerMemory(values);
+        return bytes;
+    }
+
     void resize()
     {
         auto rows = m_rows.toStrongRef();
@@ -228,6 +315,8 @@ public:
         : m_rows(rows)
     {
         QObject::connect(rows.data(), &Lines::linesChanged, this, &ModelStorageColumn::onRowsChanged);
+        QObject::connect(rows.data(), &Lines::linesRemoved, this, &ModelStorageColumn::onRowsRemoved);
+        QObject::connect(rows.data(), &Lines::linesInserted, this, &ModelStorageColumn::onRowsInserted);
         resize();
     }
 
@@ -235,7 +324,11 @@ public:
     {
         auto rows = m_rows.toStrongRef();
         if (rows)
+        {
             QObject::disconnect(rows.data(), &Lines::linesChanged, this, &ModelStorageColumn::onRowsChanged);
+            QObject::disconnect(rows.data(), &Lines::linesRemoved, this, &ModelStorageColumn::onRowsRemoved);
+            QObject::disconnect(rows.data(), &Lines::linesInserted, this, &ModelStorageColumn::onRowsInserted);
+        }
     }
 
     int size() const { return m_values.size(); }
@@ -254,6 +347,8 @@ public:
     }
 
 protected:
+    qint64 memoryUsageImpl() const override { return sizeof(*this) + containerMemory(m_values); }
+
     T valueImpl(const ItemID& item) const override
     {
         if (item.row >= m_values.size())
@@ -262,6 +357,9 @@ protected:
         return m_values[item.row];
     }
 
+    // value is shared by all columns of the row
+    ChangedItems changedItemsImpl(const ItemID& item) const override { return ChangedItems::rows(item.row, item.row); }
+
     bool setValueImpl(const ItemID& item, T value) override
     {
         if (item.row < m_values.size())
@@ -283,6 +381,18 @@ private:
             resize();
     }
 
+    void onRowsRemoved(const Lines* /*rows*/, const QVector<int>& rows)
+    {
+        removeValues(m_values, rows);
+        emit this->modelChanged(this);
+    }
+
+    void onRowsInserted(const Lines* /*rows*/, int rowBefore, int rowsCount)
+    {
+        insertValues(m_values, rowBefore, rowsCount);
+        emit this->modelChanged(this);
+    }
+
     void resize()
     {
         auto rows = m_rows.toStrongRef();
@@ -302,6 +412,8 @@ public:
         : m_columns(columns)
     {
         connect(columns.data(), &Lines::linesChanged, this, ModelStorageRow::onColumnsChanged);
+        connect(columns.data(), &Lines::linesRemoved, this, &ModelStorageRow::onColumnsRemoved);
+        connect(columns.data(), &Lines::linesInserted, this, &ModelStorageRow::onColumnsInserted);
         resize();
     }
 
@@ -309,7 +421,11 @@ public:
     {
         auto columns = m_columns.toStrongRef();
         if (columns)
+        {
             disconnect(columns.data(), &Lines::linesChanged, this, ModelStorageRow::onColumnsChanged);
+            disconnect(columns.data(), &Lines::linesRemoved, this, &ModelStorageRow::onColumnsRemoved);
+            disconnect(columns.data(), &Lines::linesInserted, this, &ModelStorageRow::onColumnsInserted);
+        }
     }
 
     int size() const { return m_values.size(); }
@@ -328,6 +444,8 @@ public:
     }
 
 protected:
+    qint64 memoryUsageImpl() const override { return sizeof(*this) + containerMemory(m_values); }
+
     T valueImpl(const ItemID& item) const override
     {
         if (item.column >= m_values.size())
@@ -336,6 +454,9 @@ protected:
         return m_values[item.column];
     }
 
+    // value is shared by all rows of the column
+    ChangedItems changedItemsImpl(const ItemID& item) const override { return ChangedItems::columns(item.column, item.column); }
+
     bool setValueImpl(const ItemID& item, T value) override
     {
         if (item.column < m_values.size())
@@ -357,6 +478,18 @@ private:
             resize();
     }
 
+    void onColumnsRemoved(const Lines* /*columns*/, const QVector<int>& columns)
+    {
+        removeValues(m_values, columns);
+        emit this->modelChanged(this);
+    }
+
+    void onColumnsInserted(const Lines* /*columns*/, int columnBefore, int columnsCount)
+    {
+        insertValues(m_values, columnBefore, columnsCount);
+        emit this->modelChanged(this);
+    }
+
     void resize()
     {
         auto columns = m_columns.toStrongRef();
@@ -378,6 +511,8 @@ public:
     }
 
 protected:
+    qint64 memoryUsageImpl() const override { return sizeof(*this) + containerMemory(m_values); }
+
     T valueImpl(const ItemID& item) const override
     {
         Q_ASSERT(!m_range || m_range->hasItem(item));
@@ -388,6 +523,8 @@ protected:
             return T();
     }
 
+    ChangedItems changedItemsImpl(const ItemID& item) const override { return ChangedItems(item); }
+
     bool setValueImpl(const ItemID& item, T value) override
     {
         Q_ASSERT(!m_range || m_range->hasItem(item));
@@ -427,6 +564,8 @@ public:
     }
 
 protected:
+    qint64 memoryUsageImpl() const override { return sizeof(*this) + containerMemory(m_values); }
+
     T valueImpl(const ItemID& item) const override
     {
         if (item.row >= m_values.size())
@@ -435,6 +574,9 @@ protected:
         return m_values[item.row];
     }
 
+    // value is shared by all columns of the row
+    ChangedItems changedItemsImpl(const ItemID& item) const override { return ChangedItems::rows(item.row, item.row); }
+
     bool setValueImpl(const ItemID& item, T value) override
     {
         if (item.row < m_values.size())
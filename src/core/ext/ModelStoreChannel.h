@@ -0,0 +1,124 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef QI_MODEL_STORE_CHANNEL_H
+#define QI_MODEL_STORE_CHANNEL_H
+
+#include "ModelTyped.h"
+#include "utils/RingBufferMPSC.h"
+#include <QCoreApplication>
+#include <QEvent>
+#include <QPair>
+#include <QThread>
+#include <QVector>
+
+namespace Qi
+{
+
+// thread-safe update channel for ModelTyped models (ModelStorage* etc.)
+// producer threads push (ItemID, value) records,
+// model thread applies them in bulk with single modelChanged notification
+template <typename T, typename StorageT = typename std::decay<T>::type>
+class ModelStoreChannel: public QObject
+{
+public:
+    // should be created in the model thread
+    ModelStoreChannel(const QSharedPointer<ModelTyped<T>>& model, int capacity = 65536)
+        : m_model(model),
+          m_records(capacity),
+          m_isAutoDrain(true),
+          m_isDrainScheduled(false)
+    {
+        Q_ASSERT(model);
+        Q_ASSERT(model->thread() == thread());
+    }
+
+    int capacity() const { return m_records.capacity(); }
+
+    // drains records on the next model thread event loop pass
+    bool isAutoDrain() const { return m_isAutoDrain.load(); }
+    void setAutoDrain(bool autoDrain) { m_isAutoDrain.store(autoDrain); }
+
+    // can be called from any thread
+    // returns false if channel is full and record has been dropped
+    bool push(const ItemID& item, T value)
+    {
+        if (!m_records.push(Record(item, value)))
+            return false;
+
+        // post single drain event per batch
+        if (m_isAutoDrain.load(std::memory_order_relaxed) && !m_isDrainScheduled.exchange(true))
+            QCoreApplication::postEvent(this, new QEvent(drainEventType()));
+
+        return true;
+    }
+
+    // should be called from the model thread (for example once per frame)
+    // returns number of applied records
+    int drain()
+    {
+        Q_ASSERT(thread() == QThread::currentThread());
+
+        // records pushed from now on need another drain
+        m_isDrainScheduled.exchange(false);
+
+        m_batch.clear();
+        Record record;
+        while (m_records.pop(record))
+            m_batch.append(record);
+
+        if (m_batch.isEmpty())
+            return 0;
+
+        auto model = m_model.toStrongRef();
+        if (model)
+            model->setValues(m_batch);
+
+        return m_batch.size();
+    }
+
+protected:
+    bool event(QEvent* event) override
+    {
+        if (event->type() == drainEventType())
+        {
+            drain();
+            return true;
+        }
+
+        return QObject::event(event);
+    }
+
+private:
+    typedef QPair<ItemID, StorageT> Record;
+
+    static QEvent::Type drainEventType()
+    {
+        static QEvent::Type eventType = QEvent::Type(QEvent::registerEventType());
+        return eventType;
+    }
+
+    QWeakPointer<ModelTyped<T>> m_model;
+    RingBufferMPSC<Record> m_records;
+    std::atomic<bool> m_isAutoDrain;
+    std::atomic<bool> m_isDrainScheduled;
+    // reused between drains
+    QVector<Record> m_batch;
+};
+
+} // end namespace Qi
+
+#endif // QI_MODEL_STORE_CHANNEL_H
@@ -54,7 +54,7 @@ public:
     {
         if (setValueImpl(item, value))
         {
-            emit modelChanged(this);
+            emit modelChanged(this, changedItemsImpl(item));
             return true;
         }
         return false;
@@ -65,18 +65,55 @@ public:
     {
         if (setValueMultipleImpl(itemsIterator, value))
         {
-            emit modelChanged(this);
+            ChangedItems changedItems;
+            bool isFirst = true;
+            for (itemsIterator.atFirst(); itemsIterator.isValid(); itemsIterator.toNext())
+            {
+                ChangedItems itemChanges = changedItemsImpl(itemsIterator.item());
+                changedItems = isFirst ? itemChanges : changedItems.united(itemChanges);
+                isFirst = false;
+
+                if (changedItems.isAll())
+                    break;
+            }
+
+            emit modelChanged(this, changedItems);
             return true;
         }
         return false;
     }
 
+    // sets values of several items and emits single notification
+    // values - container of (ItemID, value) pairs
+    template <typename Container> bool setValues(const Container& values)
+    {
+        bool result = false;
+        ChangedItems changedItems;
+
+        for (const auto& value: values)
+        {
+            if (!setValueImpl(value.first, value.second))
+                continue;
+
+            changedItems = result ? changedItems.united(changedItemsImpl(value.first)) : changedItemsImpl(value.first);
+            result = true;
+        }
+
+        if (result)
+            emit modelChanged(this, changedItems);
+
+        return result;
+    }
+
 protected:
     int compareImpl(const ItemID& left, const ItemID& right) const override { return Private::compareValues(value(left), value(right)); }
     bool isAscendingDefaultImpl(const ItemID& /*item*/) const override { return m_ascendingDefault; }
 
     virtual ValueType_t valueImpl(const ItemID& item) const = 0;
     virtual bool setValueImpl(const ItemID& item, ValueType_t value) = 0;
+    // returns items affected by setting value of the item
+    // all items by default, models storing values per item should narrow it
+    virtual ChangedItems changedItemsImpl(const ItemID& /*item*/) const { return ChangedItems(); }
     virtual bool setValueMultipleImpl(ItemsIterator& itemsIterator, ValueType_t value)
     {
         bool result = false;
@@ -19,6 +19,23 @@
 namespace Qi
 {
 
+// ranges where item is in range if both its row and column touch the range
+static bool isLinesRange(const Range& range)
+{
+    return qobject_cast<const RangeAll*>(&range) || qobject_cast<const RangeNone*>(&range)
+            || qobject_cast<const RangeRow*>(&range) || qobject_cast<const RangeRows*>(&range)
+            || qobject_cast<const RangeColumn*>(&range) || qobject_cast<const RangeColumns*>(&range)
+            || qobject_cast<const RangeRect*>(&range) || qobject_cast<const RangeItem*>(&range);
+}
+
+static void applyItems(QBitArray& rowItems, const QBitArray& items, bool exclude)
+{
+    if (exclude)
+        rowItems &= ~items;
+    else
+        rowItems |= items;
+}
+
 RangeSelection& RangeSelection::operator=(const RangeSelection& other)
 {
     m_ranges = other.m_ranges;
@@ -40,6 +57,83 @@ void RangeSelection::addRange(const QSharedPointer<Range>& range, bool exclude)
     emit rangeChanged(this, ChangeReasonRange);
 }
 
+QVector<QBitArray> RangeSelection::selectedItems(const QVector<int>& rows, const QVector<int>& columns) const
+{
+    QVector<QBitArray> selected(rows.size(), QBitArray(columns.size()));
+
+    // later ranges override earlier ones like in hasItem
+    for (const auto& info: m_ranges)
+    {
+        const Range& range = *info.range;
+
+        if (const RangeSelection* nested = qobject_cast<const RangeSelection*>(&range))
+        {
+            QVector<QBitArray> nestedSelected = nested->selectedItems(rows, columns);
+            for (int rowIndex = 0; rowIndex < rows.size(); ++rowIndex)
+                applyItems(selected[rowIndex], nestedSelected[rowIndex], info.exclude);
+            continue;
+        }
+
+        if (isLinesRange(range))
+        {
+            QBitArray columnsMask(columns.size());
+            for (int columnIndex = 0; columnIndex < columns.size(); ++columnIndex)
+            {
+                if (range.touchesColumn(columns[columnIndex]))
+                    columnsMask.setBit(columnIndex);
+            }
+
+            if (columnsMask.count(true) == 0)
+                continue;
+
+            for (int rowIndex = 0; rowIndex < rows.size(); ++rowIndex)
+            {
+                if (range.touchesRow(rows[rowIndex]))
+                    applyItems(selected[rowIndex], columnsMask, info.exclude);
+            }
+            continue;
+        }
+
+        // callbacks and custom ranges are checked by items
+        for (int rowIndex = 0; rowIndex < rows.size(); ++rowIndex)
+        {
+            if (!range.touchesRow(rows[rowIndex]))
+                continue;
+
+            QBitArray& rowItems = selected[rowIndex];
+            for (int columnIndex = 0; columnIndex < columns.size(); ++columnIndex)
+            {
+                if (range.hasItem(rows[rowIndex], columns[columnIndex]))
+                    rowItems.setBit(columnIndex, !info.exclude);
+            }
+        }
+    }
+
+    return selected;
+}
+
+bool RangeSelection::touchesRowImpl(int row) const
+{
+    for (const auto& range: m_ranges)
+    {
+        if (!range.exclude && range.range->touchesRow(row))
+            return true;
+    }
+
+    return false;
+}
+
+bool RangeSelection::touchesColumnImpl(int column) const
+{
+    for (const auto& range: m_ranges)
+    {
+        if (!range.exclude && range.range->touchesColumn(column))
+            return true;
+    }
+
+    return false;
+}
+
 bool RangeSelection::hasItemImpl(const ItemID &item) const
 {
     bool excluded = true;
@@ -82,6 +176,15 @@ bool RangeSelection::hasColumnImpl(int column) const
     return !excluded;
 }
 
+qint64 RangeSelection::memoryUsageImpl() const
+{
+    qint64 bytes = sizeof(*this) + containerMemory(m_ranges);
+    for (const auto& range: m_ranges)
+        bytes += range.range->memoryUsage();
+
+    return bytes;
+}
+
 RangeNone::RangeNone()
 {
 }
@@ -159,6 +262,16 @@ bool RangeColumn::hasColumnImpl(int column) const
     return column == m_column;
 }
 
+bool RangeColumn::touchesRowImpl(int /*row*/) const
+{
+    return true;
+}
+
+bool RangeColumn::touchesColumnImpl(int column) const
+{
+    return column == m_column;
+}
+
 QSharedPointer<RangeColumn> makeRangeColumn(int column)
 {
     return QSharedPointer<RangeColumn>::create(column);
@@ -200,6 +313,16 @@ bool RangeColumns::hasColumnImpl(int column) const
     return m_columns.contains(column);
 }
 
+bool RangeColumns::touchesRowImpl(int /*row*/) const
+{
+    return !m_columns.isEmpty();
+}
+
+bool RangeColumns::touchesColumnImpl(int column) const
+{
+    return m_columns.contains(column);
+}
+
 QSharedPointer<RangeColumns> makeRangeColumns(const QSet<int>& columns)
 {
     return QSharedPointer<RangeColumns>::create(columns);
@@ -239,6 +362,16 @@ bool RangeRow::hasColumnImpl(int /*column*/) const
     return false;
 }
 
+bool RangeRow::touchesRowImpl(int row) const
+{
+    return row == m_row;
+}
+
+bool RangeRow::touchesColumnImpl(int /*column*/) const
+{
+    return true;
+}
+
 QSharedPointer<RangeRow> makeRangeRow(int row)
 {
     return QSharedPointer<RangeRow>::create(row);
@@ -280,6 +413,16 @@ bool RangeRows::hasColumnImpl(int /*column*/) const
     return false;
 }
 
+bool RangeRows::touchesRowImpl(int row) const
+{
+    return m_rows.contains(row);
+}
+
+bool RangeRows::touchesColumnImpl(int /*column*/) const
+{
+    return !m_rows.isEmpty();
+}
+
 QSharedPointer<RangeRows> makeRangeRows(const QSet<int>& rows)
 {
     return QSharedPointer<RangeRows>::create(rows);
@@ -341,6 +484,16 @@ bool RangeRect::hasColumnImpl(int column) const
     return m_columns.contains(column);
 }
 
+bool RangeRect::touchesRowImpl(int row) const
+{
+    return m_rows.contains(row) && !m_columns.isEmpty();
+}
+
+bool RangeRect::touchesColumnImpl(int column) const
+{
+    return m_columns.contains(column) && !m_rows.isEmpty();
+}
+
 QSharedPointer<RangeRect> makeRangeRect(const QSet<int>& rows, const QSet<int>& columns)
 {
     return QSharedPointer<RangeRect>::create(rows, columns);
@@ -380,6 +533,16 @@ bool RangeItem::hasColumnImpl(int column) const
     return m_item.column == column;
 }
 
+bool RangeItem::touchesRowImpl(int row) const
+{
+    return m_item.row == row;
+}
+
+bool RangeItem::touchesColumnImpl(int column) const
+{
+    return m_item.column == column;
+}
+
 QSharedPointer<RangeItem> makeRangeItem(const ItemID& item)
 {
     return QSharedPointer<RangeItem>::create(item);
@@ -18,8 +18,10 @@
 #define QI_RANGES_H
 
 #include "core/Range.h"
+#include "utils/MemoryUsage.h"
 #include <QSet>
 #include <QVector>
+#include <QBitArray>
 #include <QSharedPointer>
 #include <functional>
 
@@ -60,10 +62,18 @@ public:
     void clear();
     void addRange(const QSharedPointer<Range>& range, bool exclude);
 
+    // returns items of rows by columns in the selection, one bit array of columns per row
+    // line ranges (rows, columns, rects and so on) are applied by whole lines
+    QVector<QBitArray> selectedItems(const QVector<int>& rows, const QVector<int>& columns) const;
+
 protected:
     bool hasItemImpl(const ItemID &item) const override;
     bool hasRowImpl(int row) const override;
     bool hasColumnImpl(int column) const override;
+    // true if any not excluded range touches the line
+    bool touchesRowImpl(int row) const override;
+    bool touchesColumnImpl(int column) const override;
+    qint64 memoryUsageImpl() const override;
 
 private:
     struct RangeInfo
@@ -86,6 +96,8 @@ protected:
     bool hasItemImpl(const ItemID &item) const override;
     bool hasRowImpl(int row) const override;
     bool hasColumnImpl(int column) const override;
+    bool touchesRowImpl(int /*row*/) const override { return false; }
+    bool touchesColumnImpl(int /*column*/) const override { return false; }
 };
 QI_EXPORT QSharedPointer<RangeNone> makeRangeNone();
 
@@ -117,6 +129,8 @@ protected:
     bool hasItemImpl(const ItemID &item) const override;
     bool hasRowImpl(int row) const override;
     bool hasColumnImpl(int column) const override;
+    bool touchesRowImpl(int row) const override;
+    bool touchesColumnImpl(int column) const override;
 
 private:
     int m_column;
@@ -138,6 +152,9 @@ protected:
     bool hasItemImpl(const ItemID &item) const override;
     bool hasRowImpl(int row) const override;
     bool hasColumnImpl(int column) const override;
+    bool touchesRowImpl(int row) const override;
+    bool touchesColumnImpl(int column) const override;
+    qint64 memoryUsageImpl() const override { return sizeof(*this) + containerMemory(m_columns); }
 
 private:
     QSet<int> m_columns;
@@ -159,6 +176,8 @@ protected:
     bool hasItemImpl(const ItemID &item) const override;
     bool hasRowImpl(int row) const override;
     bool hasColumnImpl(int column) const override;
+    bool touchesRowImpl(int row) const override;
+    bool touchesColumnImpl(int column) const override;
 
 private:
     int m_row;
@@ -180,6 +199,9 @@ protected:
     bool hasItemImpl(const ItemID &item) const override;
     bool hasRowImpl(int row) const override;
     bool hasColumnImpl(int column) const override;
+    bool touchesRowImpl(int row) const override;
+    bool touchesColumnImpl(int column) const override;
+    qint64 memoryUsageImpl() const override { return sizeof(*this) + containerMemory(m_rows); }
 
 private:
     QSet<int> m_rows;
@@ -205,6 +227,9 @@ protected:
     bool hasItemImpl(const ItemID &item) const override;
     bool hasRowImpl(int row) const override;
     bool hasColumnImpl(int column) const override;
+    bool touchesRowImpl(int row) const override;
+    bool touchesColumnImpl(int column) const override;
+    qint64 memoryUsageImpl() const override { return sizeof(*this) + containerMemory(m_rows) + containerMemory(m_columns); }
 
 private:
     QSet<int> m_rows;
@@ -227,6 +252,8 @@ protected:
     bool hasItemImpl(const ItemID &item) const override;
     bool hasRowImpl(int row) const override;
     bool hasColumnImpl(int column) const override;
+    bool touchesRowImpl(int row) const override;
+    bool touchesColumnImpl(int column) const override;
 
 private:
     ItemID m_item;
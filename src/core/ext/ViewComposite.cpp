@@ -88,6 +88,25 @@ QSize ViewComposite::sizeImpl(const GuiContext& ctx, const ItemID& item, ViewSiz
                  size.height() + m_margins.top() + m_margins.bottom());
 }
 
+bool ViewComposite::layoutKeyImpl(const ItemID& item, QString& key) const
+{
+    key.clear();
+    QString subKey;
+    for (const auto& subView: m_subViews)
+    {
+        subKey.clear();
+        // all sub views should support layout sharing
+        if (!subView.view->layoutKey(item, subKey))
+            return false;
+
+        // separator keeps sub keys apart
+        key.append(subKey);
+        key.append(QChar(0));
+    }
+
+    return true;
+}
+
 void ViewComposite::drawImpl(QPainter* painter, const GuiContext& ctx, const CacheContext& cache, bool* /*showTooltip*/) const
 {
     for (const auto& subCacheView: cache.cacheView.subViews())
@@ -148,10 +167,10 @@ void ViewComposite::disconnectSubViews()
     }
 }
 
-void ViewComposite::onSubViewChanged(const View* /*view*/, ChangeReason reason)
+void ViewComposite::onSubViewChanged(const View* /*view*/, ChangeReason reason, const ChangedItems& items)
 {
     // forward signal
-    emitViewChanged(reason);
+    emitViewChanged(reason, items);
 }
 
 } // end namespace Qi
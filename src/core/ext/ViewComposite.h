@@ -42,12 +42,15 @@ protected:
     void addViewImpl(const ItemID& item, QVector<const View*>& views) const override;
     CacheView* addCacheViewImpl(const Layout& layout, const GuiContext& ctx, const ItemID& item, QVector<CacheView>& cacheViews, QRect& itemRect, QRect* visibleItemRect) const override;
     QSize sizeImpl(const GuiContext& ctx, const ItemID& item, ViewSizeMode sizeMode) const override;
+    bool layoutKeyImpl(const ItemID& item, QString& key) const override;
     void drawImpl(QPainter* painter, const GuiContext& ctx, const CacheContext& cache, bool* showTooltip) const override;
     //void cleanupDrawImpl(QPainter* painter, const GuiContext& ctx, const CacheContext& cache) const override;
+    ViewDrawPass drawPassImpl() const override { return ViewDrawPassSubViews; }
+    bool isDrawReentrantImpl() const override { return true; }
     bool textImpl(const ItemID& item, QString& txt) const override;
 
 private slots:
-    void onSubViewChanged(const View* view, ChangeReason reason);
+    void onSubViewChanged(const View* view, ChangeReason reason, const ChangedItems& items);
 
 private:
     void connectSubViews();
@@ -58,6 +58,22 @@ enum ViewDefaultController
     ViewDefaultControllerCreate = 0x1
 };
 
+// painting passes of cache spaces drawing items in grouped passes
+enum ViewDrawPass
+{
+    // item backgrounds
+    ViewDrawPassBackground = 0,
+    // panels, images and controls
+    ViewDrawPassFill,
+    // texts
+    ViewDrawPassText,
+    // borders and marks over the item
+    ViewDrawPassDecoration,
+    ViewDrawPassCount,
+    // sub views are drawn in their own passes
+    ViewDrawPassSubViews = ViewDrawPassCount
+};
+
 class QI_EXPORT GuiContext
 {
 public:
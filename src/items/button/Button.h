@@ -36,6 +36,9 @@ public:
 
 protected:
     void drawImpl(QPainter* painter, const GuiContext& ctx, const CacheContext& cache, bool* showTooltip) const override;
+    // button content is drawn over the button
+    ViewDrawPass drawPassImpl() const override { return ViewDrawPassFill; }
+    bool isDrawReentrantImpl() const override { return false; }
 
 private:
     PushableTracker m_pushableTracker;
@@ -81,9 +81,9 @@ bool ViewCacheSpace::tooltipByPointImpl(const QPoint& point, const ItemID& item,
     return cacheSpace->tooltipByPoint(point, tooltipInfo);
 }
 
-void ViewCacheSpace::onModelChanged(const Model*)
+void ViewCacheSpace::onModelChanged(const Model*, const ChangedItems& items)
 {
-    emitViewChanged(ChangeReasonViewContent);
+    emitViewChanged(ChangeReasonViewContent, items);
 }
 
 ControllerMouseCacheSpace::ControllerMouseCacheSpace(const QSharedPointer<ModelCacheSpace>& model)
@@ -47,7 +47,7 @@ protected:
     bool tooltipByPointImpl(const QPoint& point, const ItemID& item, TooltipInfo &tooltipInfo) const override;
 
 private slots:
-    void onModelChanged(const Model*);
+    void onModelChanged(const Model*, const ChangedItems& items);
 
 private:
     QSharedPointer<ModelCacheSpace> m_model;
@@ -63,6 +63,8 @@ public:
 
 private:
     void tryActivateImpl(QVector<ControllerMouse*>& activatedControllers, const ActivationInfo& activationInfo) override;
+    // nested cache space activates its own items by point
+    bool isActivationPointSensitiveImpl() const override { return true; }
 
     QSharedPointer<ModelCacheSpace> m_model;
 };
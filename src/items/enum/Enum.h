@@ -187,6 +187,9 @@ protected:
         return m_sizes[value] = ViewText::sizeImpl(ctx, item, sizeMode);
     }
 
+    // enum traits are not required to be thread safe
+    bool isDrawReentrantImpl() const override { return false; }
+
 private:
     QSharedPointer<ModelEnum<EnumType>> m_model;
     mutable QMap<EnumType, QSize> m_sizes;
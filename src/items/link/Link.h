@@ -38,6 +38,8 @@ public:
 
 protected:
     void drawImpl(QPainter* painter, const GuiContext& ctx, const CacheContext& cache, bool* showTooltip) const override;
+    // push state is tracked by GUI thread
+    bool isDrawReentrantImpl() const override { return false; }
 
 private:
     PushableTracker m_pushableTracker;
@@ -39,6 +39,8 @@ public:
 
 protected:
     bool acceptImpl(const ActivationInfo& activationInfo) const override;
+    // accepts only near the right edge of the view
+    bool isActivationPointSensitiveImpl() const override { return true; }
     void activateImpl(const ActivationInfo& activationInfo) override;
     void deactivateImpl() override;
 
@@ -69,6 +71,8 @@ public:
 
 protected:
     bool acceptImpl(const ActivationInfo& activationInfo) const override;
+    // accepts only near the bottom edge of the view
+    bool isActivationPointSensitiveImpl() const override { return true; }
     void activateImpl(const ActivationInfo& activationInfo) override;
     void deactivateImpl() override;
 
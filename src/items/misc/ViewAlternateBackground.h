@@ -31,7 +31,10 @@ public:
     ViewAlternateBackground();
 
 protected:
+    bool layoutKeyImpl(const ItemID& /*item*/, QString& key) const override { key.clear(); return true; }
     void drawImpl(QPainter* painter, const GuiContext& ctx, const CacheContext& cache, bool* showTooltip) const override;
+    ViewDrawPass drawPassImpl() const override { return ViewDrawPassBackground; }
+    bool isDrawReentrantImpl() const override { return true; }
 };
 
 } // end namespace Qi
@@ -15,6 +15,7 @@
 */
 
 #include "ViewItemBorder.h"
+#include "misc/GridLinesBatch.h"
 
 namespace Qi
 {
@@ -47,11 +48,21 @@ void ViewRowBorder::drawImpl(QPainter* painter, const GuiContext& ctx, const Cac
 {
     validateGridColor(m_gridColor, ctx);
 
+    const QRect& rect = cache.cacheView.rect();
+    QLine line(rect.right(), rect.bottom(), rect.left(), rect.bottom());
+
+    // cache space draws all grid lines at once
+    auto gridLines = GridLinesBatch::current();
+    if (gridLines)
+    {
+        gridLines->addLine(m_gridColor, line);
+        return;
+    }
+
     QPen oldPen = painter->pen();
     painter->setPen(m_gridColor);
 
-    const QRect& rect = cache.cacheView.rect();
-    painter->drawLine(rect.right(), rect.bottom(), rect.left(), rect.bottom());
+    painter->drawLine(line);
 
     painter->setPen(oldPen);
 }
@@ -69,11 +80,21 @@ void ViewColumnBorder::drawImpl(QPainter* painter, const GuiContext& ctx, const
 {
     validateGridColor(m_gridColor, ctx);
 
+    const QRect& rect = cache.cacheView.rect();
+    QLine line(rect.right(), rect.top(), rect.right(), rect.bottom());
+
+    // cache space draws all grid lines at once
+    auto gridLines = GridLinesBatch::current();
+    if (gridLines)
+    {
+        gridLines->addLine(m_gridColor, line);
+        return;
+    }
+
     QPen oldPen = painter->pen();
     painter->setPen(m_gridColor);
 
-    const QRect& rect = cache.cacheView.rect();
-    painter->drawLine(rect.right(), rect.top(), rect.right(), rect.bottom());
+    painter->drawLine(line);
 
     painter->setPen(oldPen);
 }
@@ -32,7 +32,11 @@ public:
 
 protected:
     QSize sizeImpl(const GuiContext& ctx, const ItemID& item, ViewSizeMode sizeMode) const override;
+    bool layoutKeyImpl(const ItemID& /*item*/, QString& key) const override { key.clear(); return true; }
     void drawImpl(QPainter* painter, const GuiContext& ctx, const CacheContext& cache, bool* showTooltip) const override;
+    ViewDrawPass drawPassImpl() const override { return ViewDrawPassDecoration; }
+    // grid color is taken from the style on first draw
+    bool isDrawReentrantImpl() const override { return m_gridColor.isValid(); }
 
 private:
     mutable QColor m_gridColor;
@@ -48,7 +52,11 @@ public:
 
 protected:
     QSize sizeImpl(const GuiContext& ctx, const ItemID& item, ViewSizeMode sizeMode) const override;
+    bool layoutKeyImpl(const ItemID& /*item*/, QString& key) const override { key.clear(); return true; }
     void drawImpl(QPainter* painter, const GuiContext& ctx, const CacheContext& cache, bool* showTooltip) const override;
+    ViewDrawPass drawPassImpl() const override { return ViewDrawPassDecoration; }
+    // grid color is taken from the style on first draw
+    bool isDrawReentrantImpl() const override { return m_gridColor.isValid(); }
 
 private:
     mutable QColor m_gridColor;
@@ -64,7 +72,11 @@ public:
 
 protected:
     QSize sizeImpl(const GuiContext& ctx, const ItemID& item, ViewSizeMode sizeMode) const override;
+    bool layoutKeyImpl(const ItemID& /*item*/, QString& key) const override { key.clear(); return true; }
     void drawImpl(QPainter* painter, const GuiContext& ctx, const CacheContext& cache, bool* showTooltip) const override;
+    ViewDrawPass drawPassImpl() const override { return ViewDrawPassDecoration; }
+    // grid color is taken from the style on first draw
+    bool isDrawReentrantImpl() const override { return m_gridColor.isValid(); }
 
 private:
     mutable QColor m_gridColor;
@@ -66,6 +66,7 @@ public:
 
 protected:
     void drawImpl(QPainter* painter, const GuiContext& ctx, const CacheContext& cache, bool* showTooltip) const override;
+    ViewDrawPass drawPassImpl() const override { return ViewDrawPassText; }
 
 private:
     ProgressLabelMode m_mode;
@@ -16,6 +16,7 @@
 
 #include "Radio.h"
 #include "items/misc/ControllerMousePushableCallback.h"
+#include "misc/StylePixmapCache.h"
 #include <QStyleOptionButton>
 
 namespace Qi
@@ -65,8 +66,13 @@ bool ModelRadioStorage::setRadioItemImpl(const ItemID& item)
     if (m_radioItem == item)
         return false;
 
+    // previous and new radio items have been changed
+    ChangedItems changedItems(item);
+    if (m_radioItem.isValid())
+        changedItems = changedItems.united(ChangedItems(m_radioItem));
+
     m_radioItem = item;
-    emit modelChanged(this);
+    emit modelChanged(this, changedItems);
 
     return true;
 }
@@ -106,7 +112,7 @@ void ViewRadio::drawImpl(QPainter* painter, const GuiContext& ctx, const CacheCo
     option.rect = style->subElementRect(QStyle::SE_RadioButtonIndicator, &option, ctx.widget);
 
     // draw radio button image
-    style->drawPrimitive(QStyle::PE_IndicatorRadioButton, &option, painter, ctx.widget);
+    StylePixmapCache::drawPrimitive(style, QStyle::PE_IndicatorRadioButton, option, painter, ctx.widget);
 }
 
 QStyle::State ViewRadio::styleState(const ItemID& item) const
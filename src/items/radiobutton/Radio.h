@@ -88,6 +88,7 @@ public:
 
 protected:
     QSize sizeImpl(const GuiContext& ctx, const ItemID& item, ViewSizeMode sizeMode) const override;
+    bool layoutKeyImpl(const ItemID& /*item*/, QString& key) const override { key.clear(); return true; }
     void drawImpl(QPainter* painter, const GuiContext& ctx, const CacheContext& cache, bool* showTooltip) const override;
 
 private:
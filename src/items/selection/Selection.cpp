@@ -17,6 +17,7 @@
 #include "Selection.h"
 #include "cache/space/CacheSpaceGrid.h"
 #include "widgets/core/SpaceWidgetCore.h"
+#include "misc/StylePixmapCache.h"
 #include <QStyleOptionViewItem>
 
 namespace Qi
@@ -137,11 +138,47 @@ void ModelSelectionRows::selectRows(const QSet<int>& rows)
     setSelection(QSharedPointer<RangeRows>::create(rows));
 }
 
+QVector<QBitArray> ModelSelectionRows::selectedItemsImpl(const QVector<int>& rows, const QVector<int>& columns) const
+{
+    QVector<QBitArray> selected(rows.size(), QBitArray(columns.size()));
+    for (int rowIndex = 0; rowIndex < rows.size(); ++rowIndex)
+    {
+        if (isRowSelected(rows[rowIndex]))
+            selected[rowIndex].fill(true);
+    }
+
+    return selected;
+}
+
+QVector<QBitArray> ModelSelectionRow::selectedItemsImpl(const QVector<int>& rows, const QVector<int>& columns) const
+{
+    QVector<QBitArray> selected(rows.size(), QBitArray(columns.size()));
+    for (int rowIndex = 0; rowIndex < rows.size(); ++rowIndex)
+    {
+        if (isRowSelected(rows[rowIndex]))
+            selected[rowIndex].fill(true);
+    }
+
+    return selected;
+}
+
 void ModelSelectionColumns::selectColumns(const QSet<int>& columns)
 {
     setSelection(QSharedPointer<RangeColumns>::create(columns));
 }
 
+QVector<QBitArray> ModelSelectionColumns::selectedItemsImpl(const QVector<int>& rows, const QVector<int>& columns) const
+{
+    QBitArray selectedColumns(columns.size());
+    for (int columnIndex = 0; columnIndex < columns.size(); ++columnIndex)
+    {
+        if (isColumnSelected(columns[columnIndex]))
+            selectedColumns.setBit(columnIndex);
+    }
+
+    return QVector<QBitArray>(rows.size(), selectedColumns);
+}
+
 ViewSelectionClient::ViewSelectionClient(const QSharedPointer<ModelSelection>& model, bool useDefaultController)
     : ViewModeled<ModelSelection>(model)
 {
@@ -199,7 +236,7 @@ void ViewSelectionClient::drawImpl(QPainter* painter, const GuiContext& ctx, con
         option.state |= QStyle::State_Selected;
         painter->setPen(ctx.widget->palette().highlightedText().color());
 
-        style->drawPrimitive(QStyle::PE_PanelItemViewItem, &option, painter, ctx.widget);
+        StylePixmapCache::drawPrimitive(style, QStyle::PE_PanelItemViewItem, option, painter, ctx.widget);
     }
 
     // draw focus rect for active item
@@ -212,6 +249,20 @@ void ViewSelectionClient::drawImpl(QPainter* painter, const GuiContext& ctx, con
     }
 }
 
+void ViewSelectionClient::drawStateImpl(QPainter* painter, const GuiContext& ctx, const CacheContext& cache) const
+{
+    m_painterState.save(painter);
+
+    // following views draw text of selected item
+    if (theModel()->isItemSelected(cache.item))
+    {
+        if (ctx.style()->inherits("QWindowsVistaStyle"))
+            painter->setPen(ctx.widget->palette().color(ctx.colorGroup(), QPalette::HighlightedText));
+        else
+            painter->setPen(ctx.widget->palette().highlightedText().color());
+    }
+}
+
 void ViewSelectionClient::cleanupDrawImpl(QPainter* painter, const GuiContext& /*ctx*/, const CacheContext& /*cache*/) const
 {
     m_painterState.restore(painter);
@@ -250,7 +301,7 @@ void ViewSelectionHeader::drawImpl(QPainter* painter, const GuiContext& ctx, con
         option.orientation = Qt::Vertical;
     }
 
-    ctx.widget->style()->drawControl(QStyle::CE_HeaderSection, &option, painter, ctx.widget);
+    StylePixmapCache::drawHeaderSection(ctx.style(), option, painter, ctx.widget);
 }
 
 ControllerMouseSelectionClient::ControllerMouseSelectionClient(const QSharedPointer<ModelSelection>& model)
@@ -43,6 +43,13 @@ public:
     bool isItemSelected(const ItemID& item) const { return isItemSelectedImpl(item); }
     bool isVisibleItemSelected(const ItemID& visibleItem) const;
 
+    // returns false if the row or column has no selected items
+    // allows to skip lines without checking each item
+    bool mayHaveSelectedRow(int row) const { return mayHaveSelectedRowImpl(row); }
+    bool mayHaveSelectedColumn(int column) const { return mayHaveSelectedColumnImpl(column); }
+    // returns selected items of rows by columns, one bit array of columns per row
+    QVector<QBitArray> selectedItems(const QVector<int>& rows, const QVector<int>& columns) const { return selectedItemsImpl(rows, columns); }
+
     void addSelection(const QSharedPointer<Range>& range, bool exclude);
     void setSelection(const QSharedPointer<Range>& range);
     void clearSelection();
@@ -73,6 +80,10 @@ protected:
     bool isAscendingDefaultImpl(const ItemID& /*item*/) const override { return false; }
 
     virtual bool isItemSelectedImpl(const ItemID& item) const { return m_selection.hasItem(item); }
+    virtual bool mayHaveSelectedRowImpl(int row) const { return m_selection.touchesRow(row); }
+    virtual bool mayHaveSelectedColumnImpl(int column) const { return m_selection.touchesColumn(column); }
+    // should be overridden together with isItemSelectedImpl
+    virtual QVector<QBitArray> selectedItemsImpl(const QVector<int>& rows, const QVector<int>& columns) const { return m_selection.selectedItems(rows, columns); }
 
     void emitChangedSignals(ChangeReason changeReason);
 
@@ -97,6 +108,9 @@ public:
 
 protected:
     bool isItemSelectedImpl(const ItemID& item) const override { return isRowSelected(item.row); }
+    bool mayHaveSelectedRowImpl(int row) const override { return isRowSelected(row); }
+    bool mayHaveSelectedColumnImpl(int /*column*/) const override { return !m_selection.isEmpty(); }
+    QVector<QBitArray> selectedItemsImpl(const QVector<int>& rows, const QVector<int>& columns) const override;
 };
 
 class QI_EXPORT ModelSelectionRow: public ModelSelection
@@ -114,6 +128,9 @@ public:
 
 protected:
     bool isItemSelectedImpl(const ItemID& item) const override { return isRowSelected(item.row); }
+    bool mayHaveSelectedRowImpl(int row) const override { return isRowSelected(row); }
+    bool mayHaveSelectedColumnImpl(int /*column*/) const override { return activeItem().row >= 0; }
+    QVector<QBitArray> selectedItemsImpl(const QVector<int>& rows, const QVector<int>& columns) const override;
 };
 
 class QI_EXPORT ModelSelectionColumns: public ModelSelection
@@ -131,6 +148,9 @@ public:
 
 protected:
     bool isItemSelectedImpl(const ItemID& item) const override { return isColumnSelected(item.column); }
+    bool mayHaveSelectedRowImpl(int /*row*/) const override { return !m_selection.isEmpty(); }
+    bool mayHaveSelectedColumnImpl(int column) const override { return isColumnSelected(column); }
+    QVector<QBitArray> selectedItemsImpl(const QVector<int>& rows, const QVector<int>& columns) const override;
 };
 
 class QI_EXPORT ViewSelectionClient: public ViewModeled<ModelSelection>
@@ -143,8 +163,10 @@ public:
     ~ViewSelectionClient();
 
 protected:
+    bool layoutKeyImpl(const ItemID& /*item*/, QString& key) const override { key.clear(); return true; }
     void drawImpl(QPainter* painter, const GuiContext& ctx, const CacheContext& cache, bool* showTooltip) const override;
     void cleanupDrawImpl(QPainter* painter, const GuiContext& ctx, const CacheContext& cache) const override;
+    void drawStateImpl(QPainter* painter, const GuiContext& ctx, const CacheContext& cache) const override;
 
 private:
     mutable PainterState m_painterState;
@@ -166,7 +188,9 @@ public:
     ViewSelectionHeader(const QSharedPointer<ModelSelection>& model, SelectionHeaderType type, bool useDefaultController = true);
 
 protected:
+    bool layoutKeyImpl(const ItemID& /*item*/, QString& key) const override { key.clear(); return true; }
     void drawImpl(QPainter* painter, const GuiContext& ctx, const CacheContext& cache, bool* showTooltip) const override;
+    ViewDrawPass drawPassImpl() const override { return ViewDrawPassBackground; }
 
 private:
     SelectionHeaderType m_type;
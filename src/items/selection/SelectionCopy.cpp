@@ -0,0 +1,378 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "SelectionCopy.h"
+#include "Selection.h"
+#include "space/SpaceGrid.h"
+#include "cache/CacheItemFactory.h"
+#include "core/View.h"
+#include "misc/Trace.h"
+#include <QMimeData>
+#include <QStringList>
+#include <limits>
+#include <algorithm>
+
+namespace Qi
+{
+
+static const char* TextMimeType = "text/plain";
+
+// drops removed lines and shifts following ones, returns indexes of kept lines
+// removed - absolute lines in ascending order
+static QVector<int> removeLines(QVector<int>& lines, const QVector<int>& removed)
+{
+    QVector<int> keptIndexes;
+    QVector<int> keptLines;
+
+    for (int index = 0; index < lines.size(); ++index)
+    {
+        int line = lines[index];
+        auto it = std::lower_bound(removed.begin(), removed.end(), line);
+        if (it != removed.end() && *it == line)
+            continue;
+
+        keptIndexes.append(index);
+        keptLines.append(line - int(it - removed.begin()));
+    }
+
+    lines = keptLines;
+    return keptIndexes;
+}
+
+static void insertLines(QVector<int>& lines, int lineBefore, int count)
+{
+    for (int& line : lines)
+    {
+        if (line >= lineBefore)
+            line += count;
+    }
+}
+
+static QVector<int> lineIndexes(int count)
+{
+    QVector<int> indexes(count);
+    for (int index = 0; index < count; ++index)
+        indexes[index] = index;
+    return indexes;
+}
+
+// returns lines out of count in ascending order
+static QVector<int> staleLines(const QVector<int>& lines, int count)
+{
+    QVector<int> stale;
+    for (int line : lines)
+    {
+        if (line >= count)
+            stale.append(line);
+    }
+
+    std::sort(stale.begin(), stale.end());
+    return stale;
+}
+
+// produces text only when clipboard or drop target asks for it
+class SelectionMimeData: public QMimeData
+{
+public:
+    explicit SelectionMimeData(const SelectionCopy& copy)
+        : m_copy(copy),
+          m_isTextReady(false)
+    {
+        // copied items follow their lines until text is taken
+        const Lines* rows = m_copy.grid()->rows().data();
+        const Lines* columns = m_copy.grid()->columns().data();
+
+        connect(rows, &Lines::linesRemoved, this, [this](const Lines*, const QVector<int>& lines) {
+            if (!m_isTextReady)
+                m_copy.removeRows(lines);
+        });
+        connect(rows, &Lines::linesInserted, this, [this](const Lines*, int lineBefore, int linesCount) {
+            if (!m_isTextReady)
+                m_copy.insertRows(lineBefore, linesCount);
+        });
+        connect(columns, &Lines::linesRemoved, this, [this](const Lines*, const QVector<int>& lines) {
+            if (!m_isTextReady)
+                m_copy.removeColumns(lines);
+        });
+        connect(columns, &Lines::linesInserted, this, [this](const Lines*, int lineBefore, int linesCount) {
+            if (!m_isTextReady)
+                m_copy.insertColumns(lineBefore, linesCount);
+        });
+    }
+
+    QStringList formats() const override { return QStringList() << QLatin1String(TextMimeType); }
+    bool hasFormat(const QString& mimeType) const override { return mimeType == QLatin1String(TextMimeType); }
+
+protected:
+    QVariant retrieveData(const QString& mimeType, QVariant::Type type) const override
+    {
+        if (mimeType != QLatin1String(TextMimeType))
+            return QMimeData::retrieveData(mimeType, type);
+
+        if (!m_isTextReady)
+        {
+            m_text = m_copy.text();
+            m_isTextReady = true;
+        }
+
+        return m_text;
+    }
+
+private:
+    SelectionCopy m_copy;
+    mutable QString m_text;
+    mutable bool m_isTextReady;
+};
+
+SelectionCopy::SelectionCopy(const QSharedPointer<SpaceGrid>& grid, const ModelSelection& selection, ViewApplicationMask viewApplicationMask)
+    : m_grid(grid),
+      m_viewApplicationMask(viewApplicationMask)
+{
+    Q_ASSERT(m_grid);
+    Q_ASSERT(&selection.space() == m_grid.data());
+    TraceScope traceScope("SelectionCopy::SelectionCopy", "copy");
+
+    const Lines& rows = *m_grid->rows();
+    const Lines& columns = *m_grid->columns();
+
+    // skip whole lines without selected items
+    QVector<int> candidateRows;
+    for (int visibleRow = 0, count = rows.visibleCount(); visibleRow < count; ++visibleRow)
+    {
+        int row = rows.toAbsolute(visibleRow);
+        if (selection.mayHaveSelectedRow(row))
+            candidateRows.append(row);
+    }
+
+    QVector<int> candidateColumns;
+    for (int visibleColumn = 0, count = columns.visibleCount(); visibleColumn < count; ++visibleColumn)
+    {
+        int column = columns.toAbsolute(visibleColumn);
+        if (selection.mayHaveSelectedColumn(column))
+            candidateColumns.append(column);
+    }
+
+    if (candidateRows.isEmpty() || candidateColumns.isEmpty())
+        return;
+
+    Q_ASSERT(qint64(candidateRows.size()) * candidateColumns.size() <= std::numeric_limits<int>::max());
+
+    // selected items are enumerated by ranges of the selection
+    int columnsCount = candidateColumns.size();
+    QVector<QBitArray> selected = selection.selectedItems(candidateRows, candidateColumns);
+    QBitArray isColumnUsed(columnsCount);
+    QVector<int> usedRowIndexes;
+
+    for (int rowIndex = 0; rowIndex < candidateRows.size(); ++rowIndex)
+    {
+        if (selected[rowIndex].count(true) == 0)
+            continue;
+
+        usedRowIndexes.append(rowIndex);
+        m_rows.append(candidateRows[rowIndex]);
+        isColumnUsed |= selected[rowIndex];
+    }
+
+    QVector<int> usedColumnIndexes;
+    for (int columnIndex = 0; columnIndex < columnsCount; ++columnIndex)
+    {
+        if (isColumnUsed.testBit(columnIndex))
+        {
+            usedColumnIndexes.append(columnIndex);
+            m_columns.append(candidateColumns[columnIndex]);
+        }
+    }
+
+    if (isEmpty())
+        return;
+
+    // used rows contain only used columns
+    bool isAllSelected = true;
+    for (int rowIndex : usedRowIndexes)
+    {
+        if (selected[rowIndex] != isColumnUsed)
+        {
+            isAllSelected = false;
+            break;
+        }
+    }
+
+    if (isAllSelected)
+        return;
+
+    // pack bits for used lines
+    m_selected.resize(m_rows.size() * m_columns.size());
+    int bit = 0;
+    for (int rowIndex : usedRowIndexes)
+    {
+        const QBitArray& rowSelected = selected[rowIndex];
+        for (int columnIndex : usedColumnIndexes)
+            m_selected.setBit(bit++, rowSelected.testBit(columnIndex));
+    }
+}
+
+void SelectionCopy::removeRows(const QVector<int>& rows)
+{
+    if (rows.isEmpty())
+        return;
+
+    QVector<int> keptRowIndexes = removeLines(m_rows, rows);
+    packSelected(keptRowIndexes, lineIndexes(m_columns.size()), m_columns.size());
+}
+
+void SelectionCopy::removeColumns(const QVector<int>& columns)
+{
+    if (columns.isEmpty())
+        return;
+
+    int columnsCount = m_columns.size();
+    QVector<int> keptColumnIndexes = removeLines(m_columns, columns);
+    packSelected(lineIndexes(m_rows.size()), keptColumnIndexes, columnsCount);
+}
+
+void SelectionCopy::insertRows(int rowBefore, int count)
+{
+    insertLines(m_rows, rowBefore, count);
+}
+
+void SelectionCopy::insertColumns(int columnBefore, int count)
+{
+    insertLines(m_columns, columnBefore, count);
+}
+
+QString SelectionCopy::text() const
+{
+    // lines dropped by Lines::setCount are not reported as removed
+    QVector<int> staleRows = staleLines(m_rows, m_grid->rows()->count());
+    QVector<int> staleColumns = staleLines(m_columns, m_grid->columns()->count());
+    if (!staleRows.isEmpty() || !staleColumns.isEmpty())
+    {
+        SelectionCopy copy(*this);
+        copy.removeRows(staleRows);
+        copy.removeColumns(staleColumns);
+        return copy.text();
+    }
+
+    if (isEmpty())
+        return QString();
+
+    TraceScope traceScope("SelectionCopy::text", "copy");
+
+    // read items text column by column into contiguous buffers
+    QVector<QString> columnTexts(m_columns.size());
+    QVector<QVector<int>> columnOffsets(m_columns.size());
+
+    auto factory = m_grid->createCacheItemFactory(m_viewApplicationMask);
+
+    // tab after each item except the last one and new line after each row
+    int size = m_rows.size() * m_columns.size();
+    for (int columnIndex = 0; columnIndex < m_columns.size(); ++columnIndex)
+    {
+        readColumnText(*factory, columnIndex, columnTexts[columnIndex], columnOffsets[columnIndex]);
+        size += columnTexts[columnIndex].size();
+    }
+
+    QString text;
+    text.reserve(size);
+
+    for (int rowIndex = 0; rowIndex < m_rows.size(); ++rowIndex)
+    {
+        for (int columnIndex = 0; columnIndex < m_columns.size(); ++columnIndex)
+        {
+            if (columnIndex > 0)
+                text.append(QLatin1Char('\t'));
+
+            const QVector<int>& offsets = columnOffsets[columnIndex];
+            int offset = offsets[rowIndex];
+            text.append(columnTexts[columnIndex].constData() + offset, offsets[rowIndex + 1] - offset);
+        }
+
+        text.append(QLatin1Char('\n'));
+    }
+
+    Q_ASSERT(text.size() == size);
+    return text;
+}
+
+QMimeData* SelectionCopy::createMimeData() const
+{
+    return new SelectionMimeData(*this);
+}
+
+bool SelectionCopy::isSelected(int rowIndex, int columnIndex) const
+{
+    return m_selected.isEmpty() || m_selected.testBit(rowIndex * m_columns.size() + columnIndex);
+}
+
+void SelectionCopy::packSelected(const QVector<int>& rowIndexes, const QVector<int>& columnIndexes, int oldColumnsCount)
+{
+    if (m_selected.isEmpty())
+        return;
+
+    QBitArray selected(rowIndexes.size() * columnIndexes.size());
+    int bit = 0;
+    for (int rowIndex : rowIndexes)
+    {
+        for (int columnIndex : columnIndexes)
+            selected.setBit(bit++, m_selected.testBit(rowIndex * oldColumnsCount + columnIndex));
+    }
+
+    m_selected = selected;
+}
+
+void SelectionCopy::readColumnText(const CacheItemFactory& factory, int columnIndex, QString& text, QVector<int>& offsets) const
+{
+    // schema is resolved once if it doesn't depend on rows
+    bool isSameSchema = m_grid->hint() == SpaceGridHintSameSchemasByColumn;
+    bool isSchemaResolved = false;
+
+    CacheItemInfo info;
+    QString field;
+
+    offsets.resize(m_rows.size() + 1);
+    offsets[0] = 0;
+
+    for (int rowIndex = 0; rowIndex < m_rows.size(); ++rowIndex)
+    {
+        if (isSelected(rowIndex, columnIndex))
+        {
+            info.item = ItemID(m_rows[rowIndex], m_columns[columnIndex]);
+            if (!isSameSchema || !isSchemaResolved)
+            {
+                factory.updateSchema(info);
+                isSchemaResolved = true;
+            }
+
+            field.clear();
+            if (info.schema.view && info.schema.view->text(info.item, field))
+            {
+                // separators inside items would break rows and columns
+                int start = text.size();
+                text.append(field);
+                for (int i = start; i < text.size(); ++i)
+                {
+                    QChar c = text.at(i);
+                    if (c == QLatin1Char('\t') || c == QLatin1Char('\n') || c == QLatin1Char('\r'))
+                        text[i] = QLatin1Char(' ');
+                }
+            }
+        }
+
+        offsets[rowIndex + 1] = text.size();
+    }
+}
+
+} // end namespace Qi
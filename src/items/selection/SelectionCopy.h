@@ -0,0 +1,80 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef QI_SELECTION_COPY_H
+#define QI_SELECTION_COPY_H
+
+#include "core/misc/ViewAuxiliary.h"
+#include <QBitArray>
+#include <QSharedPointer>
+#include <QVector>
+
+class QMimeData;
+
+namespace Qi
+{
+
+class SpaceGrid;
+class ModelSelection;
+class CacheItemFactory;
+
+// snapshot of selected visible grid items for copying
+// rows and columns without selected items are skipped
+// text is read from views only when it's requested
+class QI_EXPORT SelectionCopy
+{
+public:
+    SelectionCopy(const QSharedPointer<SpaceGrid>& grid, const ModelSelection& selection, ViewApplicationMask viewApplicationMask = ViewApplicationCopyText);
+
+    bool isEmpty() const { return m_rows.isEmpty() || m_columns.isEmpty(); }
+
+    const QSharedPointer<SpaceGrid>& grid() const { return m_grid; }
+
+    // absolute rows and columns of the copied items
+    const QVector<int>& rows() const { return m_rows; }
+    const QVector<int>& columns() const { return m_columns; }
+
+    // keeps copied items in sync with removed or inserted grid lines
+    // lines - removed absolute lines in ascending order
+    void removeRows(const QVector<int>& rows);
+    void removeColumns(const QVector<int>& columns);
+    void insertRows(int rowBefore, int count);
+    void insertColumns(int columnBefore, int count);
+
+    // tab separated items text, rows are separated by new lines
+    QString text() const;
+
+    // mime data which calls text() on the first request of "text/plain"
+    // copied items follow removed and inserted grid lines until then
+    QMimeData* createMimeData() const;
+
+private:
+    bool isSelected(int rowIndex, int columnIndex) const;
+    // keeps bits of the lines by their old indexes
+    void packSelected(const QVector<int>& rowIndexes, const QVector<int>& columnIndexes, int oldColumnsCount);
+    void readColumnText(const CacheItemFactory& factory, int columnIndex, QString& text, QVector<int>& offsets) const;
+
+    QSharedPointer<SpaceGrid> m_grid;
+    ViewApplicationMask m_viewApplicationMask;
+    QVector<int> m_rows;
+    QVector<int> m_columns;
+    // selected items in rows by columns order, empty if all items are selected
+    QBitArray m_selected;
+};
+
+} // end namespace Qi
+
+#endif // QI_SELECTION_COPY_H
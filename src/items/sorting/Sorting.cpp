@@ -16,6 +16,7 @@
 
 #include "Sorting.h"
 #include "space/SpaceGrid.h"
+#include "misc/StylePixmapCache.h"
 
 namespace Qi
 {
@@ -112,16 +113,32 @@ void ModelGridSortingBase::disconnectModel(const Model* model)
     disconnect(model, &Model::modelChanged, this, &ModelGridSortingBase::onSortingModelChanged);
 }
 
-void ModelGridSortingBase::onSortingModelChanged(const Model* model)
+void ModelGridSortingBase::onSortingModelChanged(const Model* model, const ChangedItems& items)
 {
     if (!m_activeSortingItem.isValid())
         return;
 
-    if (sortingModel(m_activeSortingItem).data() == model)
+    if (sortingModel(m_activeSortingItem).data() != model)
+        return;
+
+    if (!items.intersects(ChangedItems::columns(m_activeSortingItem.column, m_activeSortingItem.column)))
     {
-        // mark sorting as expired
-        m_sortingExpired = true;
+        // model shared between columns may change sorted values through other column
+        // too wide changes are treated as shared
+        static const int MaxColumnsToCheck = 64;
+        int columnEnd = qMin(items.end().column, items.start().column + MaxColumnsToCheck);
+
+        bool isShared = (columnEnd != items.end().column);
+        for (int column = items.start().column; !isShared && column <= columnEnd; ++column)
+            isShared = (sortingModel(ItemID(m_activeSortingItem.row, column)).data() == model);
+
+        // sorted column is not affected
+        if (!isShared)
+            return;
     }
+
+    // mark sorting as expired
+    m_sortingExpired = true;
 }
 
 ModelGridSorting::ModelGridSorting(const QSharedPointer<SpaceGrid>& grid)
@@ -308,7 +325,7 @@ void ViewGridSorting::drawImpl(QPainter* painter, const GuiContext& ctx, const C
         option.sortIndicator = theModel()->isAscending() ? QStyleOptionHeader::SortUp : QStyleOptionHeader::SortDown;
         option.rect = rect;
 
-        ctx.style()->drawPrimitive(QStyle::PE_IndicatorHeaderArrow, &option, painter, ctx.widget);
+        StylePixmapCache::drawPrimitive(ctx.style(), QStyle::PE_IndicatorHeaderArrow, option, painter, ctx.widget, option.sortIndicator);
     }
 
     if (showTooltip) *showTooltip = true;
@@ -60,7 +60,7 @@ protected:
     void disconnectModel(const Model* model);
 
 private:
-    void onSortingModelChanged(const Model* model);
+    void onSortingModelChanged(const Model* model, const ChangedItems& items);
 
     QSharedPointer<SpaceGrid> m_grid;
     bool m_ascending;
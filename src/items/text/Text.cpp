@@ -65,6 +65,13 @@ QSize ViewText::sizeImpl(const GuiContext& ctx, const ItemID& item, ViewSizeMode
     return sizeText(theModel()->value(item), ctx, item, sizeMode);
 }
 
+bool ViewText::layoutKeyImpl(const ItemID& item, QString& key) const
+{
+    // text defines layout extent
+    key = theModel()->value(item);
+    return true;
+}
+
 void ViewText::drawImpl(QPainter* painter, const GuiContext& ctx, const CacheContext& cache, bool* showTooltip) const
 {
     drawText(theModel()->value(cache.item), painter, ctx, cache, showTooltip);
@@ -128,7 +135,6 @@ void ViewText::drawText(const QString& text, QPainter* painter, const GuiContext
     painter->drawText(rect, alignment(cache.item), textToDraw);
 }
 
-
 ViewTextOrHint::ViewTextOrHint(const QSharedPointer<ModelText>& model, ViewDefaultController createDefaultController, Qt::Alignment alignment, Qt::TextElideMode textElideMode)
     : ViewText(model, createDefaultController, alignment, textElideMode)
 {
@@ -145,6 +151,17 @@ QSize ViewTextOrHint::sizeImpl(const GuiContext& ctx, const ItemID& item, ViewSi
         return ViewText::sizeImpl(ctx, item, sizeMode);
 }
 
+bool ViewTextOrHint::layoutKeyImpl(const ItemID& item, QString& key) const
+{
+    if (isItemHint && isItemHint(item, theModel().data()))
+    {
+        key = itemHintText ? itemHintText(item, theModel().data()) : QString();
+        return true;
+    }
+    else
+        return ViewText::layoutKeyImpl(item, key);
+}
+
 void ViewTextOrHint::drawImpl(QPainter* painter, const GuiContext& ctx, const CacheContext& cache, bool* showTooltip) const
 {
     if (isItemHint && isItemHint(cache.item, theModel().data()))
@@ -175,24 +192,38 @@ bool ViewTextOrHint::tooltipTextImpl(const ItemID& item, QString& txt) const
 }
 
 ViewTextFont::ViewTextFont(const QSharedPointer<ModelFont>& model)
-    : ViewModeled<ModelFont>(model)
+    : ViewModeled<ModelFont>(model),
+      m_isFontChanged(false)
 {
 }
 
 ViewTextFont::ViewTextFont(const QFont& font)
-    : ViewModeled<ModelFont>(QSharedPointer<ModelStorageValue<QFont>>::create(font))
+    : ViewModeled<ModelFont>(QSharedPointer<ModelStorageValue<QFont>>::create(font)),
+      m_isFontChanged(false)
+{
+}
+
+void ViewTextFont::drawImpl(QPainter* painter, const GuiContext& ctx, const CacheContext& cache, bool* /*showTooltip*/) const
 {
+    drawStateImpl(painter, ctx, cache);
 }
 
-void ViewTextFont::drawImpl(QPainter* painter, const GuiContext& /*ctx*/, const CacheContext& cache, bool* /*showTooltip*/) const
+void ViewTextFont::drawStateImpl(QPainter* painter, const GuiContext& /*ctx*/, const CacheContext& cache) const
 {
+    // grouped text passes draw items of the same font one after another
+    QFont font = theModel()->value(cache.item);
+    m_isFontChanged = (font != painter->font());
+    if (!m_isFontChanged)
+        return;
+
     m_oldFont = painter->font();
-    painter->setFont(theModel()->value(cache.item));
+    painter->setFont(font);
 }
 
 void ViewTextFont::cleanupDrawImpl(QPainter* painter, const GuiContext& /*ctx*/, const CacheContext& /*cache*/) const
 {
-    painter->setFont(m_oldFont);
+    if (m_isFontChanged)
+        painter->setFont(m_oldFont);
 }
 
 ControllerMouseText::ControllerMouseText(const QSharedPointer<ModelText>& model)
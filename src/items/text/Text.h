@@ -53,7 +53,10 @@ protected:
     virtual Qt::TextElideMode textElideModeImpl(const ItemID& /*item*/) const { return m_textElideMode; }
 
     QSize sizeImpl(const GuiContext& ctx, const ItemID& item, ViewSizeMode sizeMode) const override;
+    bool layoutKeyImpl(const ItemID& item, QString& key) const override;
     void drawImpl(QPainter* painter, const GuiContext& ctx, const CacheContext& cache, bool* showTooltip) const override;
+    ViewDrawPass drawPassImpl() const override { return ViewDrawPassText; }
+    bool isDrawReentrantImpl() const override { return true; }
     bool textImpl(const ItemID& item, QString& txt) const override;
 
     QSize sizeText(const QString& text, const GuiContext& ctx, const ItemID& item, ViewSizeMode sizeMode) const;
@@ -79,7 +82,10 @@ public:
 
 protected:
     QSize sizeImpl(const GuiContext& ctx, const ItemID& item, ViewSizeMode sizeMode) const override;
+    bool layoutKeyImpl(const ItemID& item, QString& key) const override;
     void drawImpl(QPainter* painter, const GuiContext& ctx, const CacheContext& cache, bool* showTooltip) const override;
+    // hint callbacks are not required to be thread safe
+    bool isDrawReentrantImpl() const override { return false; }
     bool tooltipTextImpl(const ItemID& item, QString& txt) const override;
 };
 
@@ -97,9 +103,12 @@ public:
 protected:
     void drawImpl(QPainter* painter, const GuiContext& ctx, const CacheContext& cache, bool* showTooltip) const override;
     void cleanupDrawImpl(QPainter* painter, const GuiContext& ctx, const CacheContext& cache) const override;
+    ViewDrawPass drawPassImpl() const override { return ViewDrawPassText; }
+    void drawStateImpl(QPainter* painter, const GuiContext& ctx, const CacheContext& cache) const override;
 
 private:
     mutable QFont m_oldFont;
+    mutable bool m_isFontChanged;
 };
 
 class QI_EXPORT ControllerMouseText: public ControllerMouseInplaceEdit
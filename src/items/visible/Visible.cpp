@@ -68,12 +68,12 @@ bool ViewVisible::safeIsItemVisible(const ItemID& item) const
     return isItemVisible ? isItemVisible(item) : false;
 }
 
-void ViewVisible::onSourceViewChanged(const View* view, ChangeReason reason)
+void ViewVisible::onSourceViewChanged(const View* view, ChangeReason reason, const ChangedItems& items)
 {
     Q_UNUSED(view);
     Q_ASSERT(view == m_sourceView.data());
 
-    emit viewChanged(this, reason);
+    emit viewChanged(this, reason, items);
 }
 
 ControllerMouseVisible::ControllerMouseVisible(const QSharedPointer<ViewVisible>& view)
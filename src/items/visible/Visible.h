@@ -42,7 +42,7 @@ protected:
 
 private:
     bool safeIsItemVisible(const ItemID& item) const;
-    void onSourceViewChanged(const View* view, ChangeReason reason);
+    void onSourceViewChanged(const View* view, ChangeReason reason, const ChangedItems& items);
 
     QSharedPointer<View> m_sourceView;
     bool m_reserveSize;
@@ -0,0 +1,239 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "CacheSpaceBackingStore.h"
+#include "cache/CacheItem.h"
+#include "utils/PainterState.h"
+#include "utils/auto_value.h"
+#include "RenderStats.h"
+#include "Trace.h"
+#include "GridLinesBatch.h"
+#include <QtMath>
+
+namespace Qi
+{
+
+static int floorDiv(int value, int divider)
+{
+    return (value >= 0) ? (value / divider) : -((-value + divider - 1) / divider);
+}
+
+CacheSpaceBackingStore::CacheSpaceBackingStore(CacheSpace* cacheSpace, const QSize& tileSize)
+    : m_cacheSpace(cacheSpace),
+      m_tileSize(tileSize),
+      m_tiles(256)
+{
+    Q_ASSERT(m_cacheSpace);
+    Q_ASSERT(!m_tileSize.isEmpty());
+    // proxy should not be used by anyone else
+    Q_ASSERT(!m_cacheSpace->drawProxy);
+
+    m_cacheSpace->drawProxy = [this](const CacheSpace* cacheSpace, QPainter* painter, const GuiContext& ctx) {
+        draw(cacheSpace, painter, ctx);
+    };
+
+    connect(m_cacheSpace, &CacheSpace::cacheChanged, this, &CacheSpaceBackingStore::onCacheChanged);
+}
+
+CacheSpaceBackingStore::~CacheSpaceBackingStore()
+{
+    disconnect(m_cacheSpace, &CacheSpace::cacheChanged, this, &CacheSpaceBackingStore::onCacheChanged);
+    m_cacheSpace->drawProxy = nullptr;
+}
+
+void CacheSpaceBackingStore::setMaxTiles(int maxTiles)
+{
+    Q_ASSERT(maxTiles > 0);
+    m_tiles.setMaxCost(maxTiles);
+}
+
+qint64 CacheSpaceBackingStore::memoryUsage() const
+{
+    qint64 bytes = sizeof(*this);
+    for (const auto& tileID: m_tiles.keys())
+        bytes += m_tiles.object(tileID)->image.byteCount();
+
+    return bytes;
+}
+
+void CacheSpaceBackingStore::invalidate()
+{
+    m_tiles.clear();
+}
+
+void CacheSpaceBackingStore::invalidate(const QRect& spaceRect)
+{
+    if (spaceRect.isEmpty())
+        return;
+
+    for (const auto& tileID: m_tiles.keys())
+    {
+        QRect tileRect(tileID.column * m_tileSize.width(), tileID.row * m_tileSize.height(), m_tileSize.width(), m_tileSize.height());
+        if (!tileRect.intersects(spaceRect))
+            continue;
+
+        Tile* tile = m_tiles.object(tileID);
+        tile->validRegion -= spaceRect;
+    }
+}
+
+void CacheSpaceBackingStore::draw(const CacheSpace* cacheSpace, QPainter* painter, const GuiContext& ctx)
+{
+    Q_ASSERT(cacheSpace == m_cacheSpace);
+
+    // animation draws cache space on it's own
+    if (cacheSpace->animation())
+    {
+        cacheSpace->drawRaw(painter, ctx);
+        return;
+    }
+
+    RenderStatsTimer timer(&RenderStats::drawTime);
+    TraceScope traceScope("CacheSpaceBackingStore::draw", "paint");
+
+    cacheSpace->validateItemsCache();
+
+    const QRect& window = cacheSpace->window();
+    if (window.isEmpty())
+        return;
+
+    // visible area in space coordinates
+    QRect spaceRect(cacheSpace->scrollOffset(), window.size());
+    QPoint origin = cacheSpace->originPos();
+
+    int columnStart = floorDiv(spaceRect.left(), m_tileSize.width());
+    int columnEnd = floorDiv(spaceRect.right(), m_tileSize.width());
+    int rowStart = floorDiv(spaceRect.top(), m_tileSize.height());
+    int rowEnd = floorDiv(spaceRect.bottom(), m_tileSize.height());
+
+    // all visible tiles should fit
+    int visibleTiles = (columnEnd - columnStart + 1) * (rowEnd - rowStart + 1);
+    if (m_tiles.maxCost() < visibleTiles * 2)
+        m_tiles.setMaxCost(visibleTiles * 2);
+
+    painter->save();
+    painter->setClipRect(window, Qt::IntersectClip);
+
+    for (int row = rowStart; row <= rowEnd; ++row)
+    {
+        for (int column = columnStart; column <= columnEnd; ++column)
+        {
+            QRect tileRect(column * m_tileSize.width(), row * m_tileSize.height(), m_tileSize.width(), m_tileSize.height());
+
+            Tile* tile = this->tile(ItemID(row, column), painter);
+
+            // render newly exposed or dirty part only
+            QRect exposedRect = tileRect.intersected(spaceRect);
+            if (!tile->validRegion.contains(exposedRect))
+                drawTile(*tile, tileRect, exposedRect, painter, ctx);
+
+            painter->drawImage(tileRect.topLeft() + origin, tile->image);
+        }
+    }
+
+    painter->restore();
+
+    cacheSpace->postDrawImpl(ctx);
+}
+
+void CacheSpaceBackingStore::drawTile(Tile& tile, const QRect& tileRect, const QRect& exposedRect, QPainter* painter, const GuiContext& ctx) const
+{
+    TraceScope traceScope("CacheSpaceBackingStore::drawTile", "paint");
+
+    QRect dirtyRect = (QRegion(exposedRect) - tile.validRegion).boundingRect();
+    Q_ASSERT(!dirtyRect.isEmpty());
+
+    QPoint origin = m_cacheSpace->originPos();
+    QRect dirtyWindowRect = dirtyRect.translated(origin);
+
+    QPainter tilePainter(&tile.image);
+    copyPainterState(painter, &tilePainter);
+    tilePainter.setBackgroundMode(painter->backgroundMode());
+
+    // map space to tile coordinates
+    tilePainter.translate(-tileRect.topLeft());
+    tilePainter.setClipRect(dirtyRect);
+
+    // clear dirty area
+    tilePainter.setCompositionMode(QPainter::CompositionMode_Source);
+    tilePainter.fillRect(dirtyRect, Qt::transparent);
+    tilePainter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+
+    // map window to space coordinates
+    tilePainter.translate(-origin);
+
+    auto_value<bool> inUse(m_cacheSpace->m_cacheIsInUse, true);
+
+    GridLinesBatch gridLines;
+
+    m_cacheSpace->drawItems(&tilePainter, ctx, &dirtyWindowRect);
+
+    gridLines.draw(&tilePainter);
+
+    tile.validRegion += dirtyRect;
+}
+
+CacheSpaceBackingStore::Tile* CacheSpaceBackingStore::tile(const ItemID& tileID, const QPainter* painter)
+{
+    // fractional scaling (1.25, 1.5) needs fractional ratio
+    qreal pixelRatio = painter->device()->devicePixelRatioF();
+
+    Tile* tile = m_tiles.object(tileID);
+    // window may have been moved to a screen with other scaling
+    if (tile && qFuzzyCompare(tile->image.devicePixelRatio(), pixelRatio))
+        return tile;
+
+    tile = new Tile();
+    tile->image = QImage(qCeil(m_tileSize.width() * pixelRatio), qCeil(m_tileSize.height() * pixelRatio), QImage::Format_ARGB32_Premultiplied);
+    tile->image.setDevicePixelRatio(pixelRatio);
+    tile->image.fill(Qt::transparent);
+
+    m_tiles.insert(tileID, tile);
+    return tile;
+}
+
+void CacheSpaceBackingStore::onCacheChanged(const CacheSpace* cache, ChangeReason reason, const QRegion& windowRegion, const ChangedItems& items)
+{
+    Q_UNUSED(cache);
+    Q_ASSERT(cache == m_cacheSpace);
+
+    // scrolling and resizing keep tiles valid
+    if (reason & ChangeReasonCacheFrame)
+        return;
+
+    if (!(reason & ChangeReasonCacheItems) && !items.isAll())
+    {
+        // changed items may be painted in off-screen tiles
+        QRect spaceRect(m_cacheSpace->scrollOffset(), m_cacheSpace->window().size());
+        for (const auto& tileID: m_tiles.keys())
+        {
+            QRect tileRect(tileID.column * m_tileSize.width(), tileID.row * m_tileSize.height(), m_tileSize.width(), m_tileSize.height());
+            if (!tileRect.intersects(spaceRect))
+                m_tiles.remove(tileID);
+        }
+
+        // invalidate changed items in visible tiles
+        QPoint origin = m_cacheSpace->originPos();
+        for (const auto& rect: windowRegion.rects())
+            invalidate(rect.translated(-origin));
+
+        return;
+    }
+
+    invalidate();
+}
+
+} // end namespace Qi
@@ -0,0 +1,74 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef QI_CACHE_SPACE_BACKING_STORE_H
+#define QI_CACHE_SPACE_BACKING_STORE_H
+
+#include "cache/space/CacheSpace.h"
+#include <QCache>
+#include <QImage>
+#include <QRegion>
+
+namespace Qi
+{
+
+// draws cache space through fixed-size rendered tiles
+// tiles are kept in space coordinates and survive scrolling
+class QI_EXPORT CacheSpaceBackingStore: public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(CacheSpaceBackingStore)
+
+public:
+    CacheSpaceBackingStore(CacheSpace* cacheSpace, const QSize& tileSize = QSize(256, 256));
+    ~CacheSpaceBackingStore();
+
+    const QSize& tileSize() const { return m_tileSize; }
+
+    int maxTiles() const { return m_tiles.maxCost(); }
+    void setMaxTiles(int maxTiles);
+
+    // returns memory used by tile images in bytes
+    qint64 memoryUsage() const;
+
+    // marks all tiles for rendering
+    void invalidate();
+    // marks tiles under spaceRect for rendering
+    void invalidate(const QRect& spaceRect);
+
+private:
+    struct Tile
+    {
+        QImage image;
+        // already rendered area (in space coordinates)
+        QRegion validRegion;
+    };
+
+    void draw(const CacheSpace* cacheSpace, QPainter* painter, const GuiContext& ctx);
+    void drawTile(Tile& tile, const QRect& tileRect, const QRect& exposedRect, QPainter* painter, const GuiContext& ctx) const;
+    Tile* tile(const ItemID& tileID, const QPainter* painter);
+
+    void onCacheChanged(const CacheSpace* cache, ChangeReason reason, const QRegion& windowRegion, const ChangedItems& items);
+
+    CacheSpace* m_cacheSpace;
+    QSize m_tileSize;
+    // tiles by (row, column)
+    QCache<ItemID, Tile> m_tiles;
+};
+
+} // end namespace Qi
+
+#endif // QI_CACHE_SPACE_BACKING_STORE_H
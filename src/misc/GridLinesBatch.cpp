@@ -0,0 +1,83 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "GridLinesBatch.h"
+#include "Trace.h"
+#include <QPainter>
+
+namespace Qi
+{
+
+// cache spaces may be drawn by several threads
+static thread_local GridLinesBatch* s_current = nullptr;
+
+GridLinesBatch::GridLinesBatch()
+    : m_previous(s_current)
+{
+    s_current = this;
+}
+
+GridLinesBatch::~GridLinesBatch()
+{
+    // lines should be drawn
+    Q_ASSERT(m_colorLines.isEmpty());
+    Q_ASSERT(s_current == this);
+    s_current = m_previous;
+}
+
+GridLinesBatch* GridLinesBatch::current()
+{
+    return s_current;
+}
+
+void GridLinesBatch::addLine(const QColor& color, const QLine& line)
+{
+    // grids use one or two colors
+    for (auto& colorLines: m_colorLines)
+    {
+        if (colorLines.color == color)
+        {
+            colorLines.lines.append(line);
+            return;
+        }
+    }
+
+    ColorLines colorLines;
+    colorLines.color = color;
+    colorLines.lines.append(line);
+    m_colorLines.append(colorLines);
+}
+
+void GridLinesBatch::draw(QPainter* painter)
+{
+    if (m_colorLines.isEmpty())
+        return;
+
+    TraceScope traceScope("GridLinesBatch::draw", "paint");
+
+    QPen oldPen = painter->pen();
+
+    for (const auto& colorLines: m_colorLines)
+    {
+        painter->setPen(colorLines.color);
+        painter->drawLines(colorLines.lines);
+    }
+
+    painter->setPen(oldPen);
+    m_colorLines.clear();
+}
+
+} // end namespace Qi
@@ -0,0 +1,61 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef QI_GRID_LINES_BATCH_H
+#define QI_GRID_LINES_BATCH_H
+
+#include "QiAPI.h"
+#include <QColor>
+#include <QLine>
+#include <QVector>
+
+class QPainter;
+
+namespace Qi
+{
+
+// collects grid lines while cache space is drawn
+// and strokes them with one drawLines call per color
+class QI_EXPORT GridLinesBatch
+{
+    Q_DISABLE_COPY(GridLinesBatch)
+
+public:
+    // becomes current batch until destroyed
+    GridLinesBatch();
+    ~GridLinesBatch();
+
+    // returns batch of the cache space being drawn in the current thread or nullptr
+    static GridLinesBatch* current();
+
+    void addLine(const QColor& color, const QLine& line);
+    // draws and clears collected lines
+    void draw(QPainter* painter);
+
+private:
+    struct ColorLines
+    {
+        QColor color;
+        QVector<QLine> lines;
+    };
+
+    QVector<ColorLines> m_colorLines;
+    GridLinesBatch* m_previous;
+};
+
+} // end namespace Qi
+
+#endif // QI_GRID_LINES_BATCH_H
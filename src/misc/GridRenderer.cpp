@@ -0,0 +1,152 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "GridRenderer.h"
+#include "space/SpaceGrid.h"
+#include "cache/space/CacheSpaceGrid.h"
+#include "utils/PainterState.h"
+#include "Trace.h"
+#include <QPagedPaintDevice>
+
+namespace Qi
+{
+
+// resolution grid pixels are designed for
+static const qreal ScreenDpi = 96.;
+
+static const QWidget* createHiddenWidget(QScopedPointer<QWidget>& hiddenWidget, const QWidget* contextWidget)
+{
+    if (contextWidget)
+        return contextWidget;
+
+    hiddenWidget.reset(new QWidget());
+    hiddenWidget->ensurePolished();
+    return hiddenWidget.data();
+}
+
+GridRenderer::GridRenderer(const QSharedPointer<SpaceGrid>& grid, const QWidget* contextWidget, ViewApplicationMask viewApplicationMask)
+    : m_grid(grid),
+      m_guiContext(createHiddenWidget(m_hiddenWidget, contextWidget)),
+      m_cacheSpace(new CacheSpaceGrid(grid, viewApplicationMask))
+{
+    Q_ASSERT(m_grid);
+}
+
+GridRenderer::~GridRenderer()
+{
+}
+
+SpacePoint GridRenderer::extent() const
+{
+    return m_grid->extent();
+}
+
+void GridRenderer::render(QPainter* painter, const SpacePoint& origin, const QSize& size)
+{
+    Q_ASSERT(painter);
+    TraceScope traceScope("GridRenderer::render", "paint");
+
+    // cache items are reused between pages
+    m_cacheSpace->setWindow(QRect(QPoint(0, 0), size));
+    m_cacheSpace->setScrollPosition(origin);
+
+    painter->save();
+    copyPainterState(m_guiContext.widget, painter);
+    painter->setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing);
+    painter->setBackgroundMode(Qt::TransparentMode);
+
+    m_cacheSpace->drawRaw(painter, m_guiContext);
+
+    painter->restore();
+}
+
+bool GridRenderer::render(const QSize& pageSize, const std::function<bool(const QImage& page, const SpacePoint& origin)>& pageReady)
+{
+    Q_ASSERT(!pageSize.isEmpty());
+    Q_ASSERT(pageReady);
+
+    const QWidget* widget = m_guiContext.widget;
+    QColor background = widget->palette().color(widget->backgroundRole());
+
+    QImage page(pageSize, QImage::Format_ARGB32_Premultiplied);
+
+    bool completed = true;
+    forEachPage(pageSize, [this, &page, &background, &pageReady, &completed](const SpacePoint& origin)->bool {
+        page.fill(background);
+
+        {
+            QPainter painter(&page);
+            render(&painter, origin, page.size());
+        }
+
+        completed = pageReady(page, origin);
+        return completed;
+    });
+
+    return completed;
+}
+
+bool GridRenderer::render(QPagedPaintDevice* device)
+{
+    Q_ASSERT(device);
+
+    qreal scale = device->logicalDpiX() / ScreenDpi;
+    QSize pageSize(int(device->width() / scale), int(device->height() / scale));
+    if (pageSize.isEmpty())
+        return false;
+
+    QPainter painter;
+    if (!painter.begin(device))
+        return false;
+
+    bool isFirstPage = true;
+    bool completed = true;
+    forEachPage(pageSize, [this, device, scale, &pageSize, &painter, &isFirstPage, &completed](const SpacePoint& origin)->bool {
+        if (!isFirstPage && !device->newPage())
+        {
+            completed = false;
+            return false;
+        }
+        isFirstPage = false;
+
+        painter.save();
+        painter.scale(scale, scale);
+        painter.setClipRect(QRect(QPoint(0, 0), pageSize));
+        render(&painter, origin, pageSize);
+        painter.restore();
+
+        return true;
+    });
+
+    painter.end();
+    return completed;
+}
+
+void GridRenderer::forEachPage(const QSize& pageSize, const std::function<bool(const SpacePoint& origin)>& visitor) const
+{
+    SpacePoint gridExtent = extent();
+
+    for (qint64 y = 0; y < gridExtent.y; y += pageSize.height())
+    {
+        for (qint64 x = 0; x < gridExtent.x; x += pageSize.width())
+        {
+            if (!visitor(SpacePoint(x, y)))
+                return;
+        }
+    }
+}
+
+} // end namespace Qi
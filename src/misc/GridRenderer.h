@@ -0,0 +1,73 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef QI_GRID_RENDERER_H
+#define QI_GRID_RENDERER_H
+
+#include "core/misc/ViewAuxiliary.h"
+#include "space/Space.h"
+#include <QImage>
+#include <functional>
+
+class QPagedPaintDevice;
+
+namespace Qi
+{
+
+class SpaceGrid;
+class CacheSpaceGrid;
+
+// renders grid without widget into images or paint devices
+// page by page keeping memory independent of the grid size
+class QI_EXPORT GridRenderer
+{
+    Q_DISABLE_COPY(GridRenderer)
+
+public:
+    // contextWidget provides style, palette and font for views
+    // hidden widget is used if contextWidget is null (QApplication is required)
+    explicit GridRenderer(const QSharedPointer<SpaceGrid>& grid, const QWidget* contextWidget = nullptr, ViewApplicationMask viewApplicationMask = ViewApplicationDraw);
+    ~GridRenderer();
+
+    const QSharedPointer<SpaceGrid>& grid() const { return m_grid; }
+    const GuiContext& guiContext() const { return m_guiContext; }
+
+    // size of the whole grid in pixels
+    SpacePoint extent() const;
+
+    // draws grid area of the size at the origin into painter at (0, 0)
+    void render(QPainter* painter, const SpacePoint& origin, const QSize& size);
+
+    // renders grid by pages of pageSize row by row into one reused image
+    // stops and returns false if pageReady returns false
+    bool render(const QSize& pageSize, const std::function<bool(const QImage& page, const SpacePoint& origin)>& pageReady);
+
+    // renders grid into pages of the device (QPdfWriter, QPrinter)
+    // grid pixels are scaled as on 96 dpi screen
+    bool render(QPagedPaintDevice* device);
+
+private:
+    void forEachPage(const QSize& pageSize, const std::function<bool(const SpacePoint& origin)>& visitor) const;
+
+    QSharedPointer<SpaceGrid> m_grid;
+    QScopedPointer<QWidget> m_hiddenWidget;
+    GuiContext m_guiContext;
+    QScopedPointer<CacheSpaceGrid> m_cacheSpace;
+};
+
+} // end namespace Qi
+
+#endif // QI_GRID_RENDERER_H
@@ -0,0 +1,312 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "GridTextExporter.h"
+#include "space/SpaceGrid.h"
+#include "cache/CacheItemFactory.h"
+#include "core/View.h"
+#include "Trace.h"
+#include <QIODevice>
+#include <QThreadPool>
+#include <QSemaphore>
+#include <vector>
+
+namespace Qi
+{
+
+// chunks queued per thread to keep threads busy while chunks are written
+static const int ChunksPerThread = 2;
+
+class TextChunkTask: public QRunnable
+{
+public:
+    TextChunkTask(const std::function<void()>& read, QSemaphore& ready)
+        : m_read(read),
+          m_ready(ready)
+    {
+    }
+
+    void run() override
+    {
+        m_read();
+        m_ready.release();
+    }
+
+private:
+    std::function<void()> m_read;
+    QSemaphore& m_ready;
+};
+
+GridTextExporter::GridTextExporter(const QSharedPointer<SpaceGrid>& grid, ViewApplicationMask viewApplicationMask)
+    : m_grid(grid),
+      m_viewApplicationMask(viewApplicationMask),
+      m_format(GridTextFormatCsv),
+      m_rowsPerChunk(4096),
+      m_threads(1),
+      m_isCanceled(0)
+{
+    Q_ASSERT(m_grid);
+}
+
+GridTextExporter::~GridTextExporter()
+{
+}
+
+void GridTextExporter::setRowsPerChunk(int rowsPerChunk)
+{
+    Q_ASSERT(rowsPerChunk > 0);
+    m_rowsPerChunk = qMax(1, rowsPerChunk);
+}
+
+void GridTextExporter::setThreads(int threads)
+{
+    m_threads = qMax(1, threads);
+}
+
+bool GridTextExporter::exportText(QIODevice* device)
+{
+    Q_ASSERT(device);
+    TraceScope traceScope("GridTextExporter::exportText", "export");
+
+    m_isCanceled.storeRelease(0);
+
+    if (!device->isWritable())
+        return false;
+
+    int rowsCount = m_grid->rowsVisibleCount();
+    int columnsCount = m_grid->columnsVisibleCount();
+    if (rowsCount == 0 || columnsCount == 0)
+        return true;
+
+    // validate lazy space data before worker threads read it
+    // and read in one thread if some view is not safe for concurrent reading
+    int threads = isTextReentrant() ? m_threads : 1;
+
+    QVector<int> columns(columnsCount);
+    for (int column = 0; column < columnsCount; ++column)
+        columns[column] = m_grid->columns()->toAbsolute(column);
+
+    // resolve schemas once per column if they don't depend on rows
+    // otherwise each chunk resolves schemas with it's own factory
+    QVector<ViewSchema> columnSchemas;
+    if (m_grid->hint() == SpaceGridHintSameSchemasByColumn)
+    {
+        auto factory = m_grid->createCacheItemFactory(m_viewApplicationMask);
+        int row = m_grid->rows()->toAbsolute(0);
+
+        columnSchemas.resize(columnsCount);
+        for (int column = 0; column < columnsCount; ++column)
+        {
+            CacheItemInfo info;
+            info.item = ItemID(row, columns[column]);
+            factory->updateSchema(info);
+            columnSchemas[column] = info.schema;
+        }
+    }
+
+    int chunksCount = (rowsCount + m_rowsPerChunk - 1) / m_rowsPerChunk;
+
+    // chunk slots are reused in order so memory is bounded by slots count
+    struct Chunk
+    {
+        QByteArray text;
+        QSemaphore ready;
+    };
+
+    QScopedPointer<QThreadPool> threadPool;
+    int slotsCount = 1;
+    if (threads > 1 && chunksCount > 1)
+    {
+        threadPool.reset(new QThreadPool());
+        threadPool->setMaxThreadCount(threads);
+        slotsCount = qMin(chunksCount, threads * ChunksPerThread);
+    }
+
+    std::vector<Chunk> chunkSlots(slotsCount);
+
+    auto startChunk = [&](int chunk) {
+        Chunk* slot = &chunkSlots[chunk % slotsCount];
+        int rowBegin = chunk * m_rowsPerChunk;
+        int rowEnd = qMin(rowBegin + m_rowsPerChunk, rowsCount);
+
+        auto read = [this, slot, rowBegin, rowEnd, &columns, &columnSchemas]() {
+            slot->text = chunkText(rowBegin, rowEnd, columns, columnSchemas);
+        };
+
+        if (threadPool)
+        {
+            threadPool->start(new TextChunkTask(read, slot->ready));
+        }
+        else
+        {
+            read();
+            slot->ready.release();
+        }
+    };
+
+    int chunksStarted = 0;
+    while (chunksStarted < slotsCount)
+        startChunk(chunksStarted++);
+
+    bool completed = true;
+    // already started chunks are drained after cancellation
+    for (int chunk = 0; chunk < chunksStarted; ++chunk)
+    {
+        Chunk& slot = chunkSlots[chunk % slotsCount];
+        slot.ready.acquire();
+
+        if (completed)
+        {
+            completed = !isCanceled() && device->write(slot.text) == slot.text.size();
+
+            if (completed && progressCallback)
+            {
+                int rowsExported = qMin((chunk + 1) * m_rowsPerChunk, rowsCount);
+                completed = progressCallback(rowsExported, rowsCount);
+            }
+
+            if (!completed)
+                cancel();
+        }
+
+        slot.text.clear();
+
+        if (completed && chunksStarted < chunksCount)
+            startChunk(chunksStarted++);
+    }
+
+    return completed;
+}
+
+bool GridTextExporter::isTextReentrant() const
+{
+    // check all views the grid may use including sub views
+    QVector<const View*> views;
+    for (const auto& schema: m_grid->schemasOrdered())
+    {
+        if (schema.view)
+            schema.view->addView(ItemID(), views);
+    }
+
+    for (const View* view: views)
+    {
+        if (!view->isDrawReentrant())
+            return false;
+    }
+
+    return true;
+}
+
+QByteArray GridTextExporter::chunkText(int visibleRowBegin, int visibleRowEnd, const QVector<int>& columns, const QVector<ViewSchema>& columnSchemas) const
+{
+    TraceScope traceScope("GridTextExporter::chunkText", "export");
+
+    // factory is not thread safe so each chunk has it's own
+    QSharedPointer<CacheItemFactory> factory;
+    if (columnSchemas.isEmpty())
+        factory = m_grid->createCacheItemFactory(m_viewApplicationMask);
+
+    const Lines& rows = *m_grid->rows();
+
+    QString text;
+    QString field;
+    CacheItemInfo info;
+
+    for (int visibleRow = visibleRowBegin; visibleRow < visibleRowEnd; ++visibleRow)
+    {
+        if (isCanceled())
+            return QByteArray();
+
+        int row = rows.toAbsolute(visibleRow);
+
+        for (int column = 0; column < columns.size(); ++column)
+        {
+            if (column > 0)
+                text.append((m_format == GridTextFormatTsv) ? QLatin1Char('\t') : QLatin1Char(','));
+
+            const ViewSchema* schema = nullptr;
+            if (factory)
+            {
+                info.item = ItemID(row, columns[column]);
+                factory->updateSchema(info);
+                schema = &info.schema;
+            }
+            else
+            {
+                schema = &columnSchemas[column];
+            }
+
+            if (!schema->view)
+                continue;
+
+            field.clear();
+            if (schema->view->text(ItemID(row, columns[column]), field))
+                appendField(text, field);
+        }
+
+        text.append(QLatin1Char('\n'));
+    }
+
+    return text.toUtf8();
+}
+
+void GridTextExporter::appendField(QString& text, const QString& field) const
+{
+    switch (m_format)
+    {
+    case GridTextFormatCsv:
+    {
+        bool needQuotes = false;
+        for (QChar c: field)
+        {
+            if (c == QLatin1Char(',') || c == QLatin1Char('"') || c == QLatin1Char('\n') || c == QLatin1Char('\r'))
+            {
+                needQuotes = true;
+                break;
+            }
+        }
+
+        if (!needQuotes)
+        {
+            text.append(field);
+            return;
+        }
+
+        text.append(QLatin1Char('"'));
+        for (QChar c: field)
+        {
+            if (c == QLatin1Char('"'))
+                text.append(QLatin1Char('"'));
+            text.append(c);
+        }
+        text.append(QLatin1Char('"'));
+    } break;
+
+    case GridTextFormatTsv:
+    {
+        int start = text.size();
+        text.append(field);
+        for (int i = start; i < text.size(); ++i)
+        {
+            QChar c = text.at(i);
+            if (c == QLatin1Char('\t') || c == QLatin1Char('\n') || c == QLatin1Char('\r'))
+                text[i] = QLatin1Char(' ');
+        }
+    } break;
+    }
+}
+
+} // end namespace Qi
@@ -0,0 +1,93 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef QI_GRID_TEXT_EXPORTER_H
+#define QI_GRID_TEXT_EXPORTER_H
+
+#include "core/misc/ViewAuxiliary.h"
+#include "core/ItemSchema.h"
+#include <QAtomicInt>
+#include <functional>
+
+class QIODevice;
+
+namespace Qi
+{
+
+class SpaceGrid;
+
+enum GridTextFormat
+{
+    // comma separated, fields with special characters are quoted
+    GridTextFormatCsv,
+    // tab separated, tabs and line breaks in fields are replaced by spaces
+    GridTextFormatTsv
+};
+
+// exports text of the visible grid items through View::text
+// rows are read by chunks in worker threads and written in order
+// so memory is limited by the chunks in flight
+class QI_EXPORT GridTextExporter
+{
+    Q_DISABLE_COPY(GridTextExporter)
+
+public:
+    explicit GridTextExporter(const QSharedPointer<SpaceGrid>& grid, ViewApplicationMask viewApplicationMask = ViewApplicationCopyText);
+    ~GridTextExporter();
+
+    const QSharedPointer<SpaceGrid>& grid() const { return m_grid; }
+
+    GridTextFormat format() const { return m_format; }
+    void setFormat(GridTextFormat format) { m_format = format; }
+
+    int rowsPerChunk() const { return m_rowsPerChunk; }
+    void setRowsPerChunk(int rowsPerChunk);
+
+    // views text is read from worker threads if threads > 1 (1 by default)
+    // and all views are reentrant (see View::isDrawReentrant)
+    // so views models should be safe for concurrent reading
+    // grid should not be changed during export
+    int threads() const { return m_threads; }
+    void setThreads(int threads);
+
+    // called from exporting thread after each written chunk
+    // returning false cancels export
+    std::function<bool(int rowsExported, int rowsCount)> progressCallback;
+
+    // writes grid text into device as UTF-8
+    // returns false if export was canceled or writing failed
+    bool exportText(QIODevice* device);
+
+    // cancels running export, can be called from any thread
+    void cancel() { m_isCanceled.storeRelease(1); }
+    bool isCanceled() const { return m_isCanceled.loadAcquire() != 0; }
+
+private:
+    bool isTextReentrant() const;
+    QByteArray chunkText(int visibleRowBegin, int visibleRowEnd, const QVector<int>& columns, const QVector<ViewSchema>& columnSchemas) const;
+    void appendField(QString& text, const QString& field) const;
+
+    QSharedPointer<SpaceGrid> m_grid;
+    ViewApplicationMask m_viewApplicationMask;
+    GridTextFormat m_format;
+    int m_rowsPerChunk;
+    int m_threads;
+    QAtomicInt m_isCanceled;
+};
+
+} // end namespace Qi
+
+#endif // QI_GRID_TEXT_EXPORTER_H
@@ -0,0 +1,129 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "RenderStats.h"
+#include <QStringList>
+#include <cstring>
+
+namespace Qi
+{
+
+static const char* changeReasonNames[] = {
+    "LinesCount", "LinesCountWeak", "LinesVisibility", "LinesSize", "LinesOrder",
+    "Range", "Layout", "ViewContent", "ViewController", "ViewSize",
+    "SpaceStructure", "SpaceHint", "SpaceItemsStructure", "SpaceItemsContent",
+    "CacheItems", "CacheContent", "CacheFrame"
+};
+
+static const int changeReasonsCount = sizeof(changeReasonNames) / sizeof(changeReasonNames[0]);
+
+bool RenderStats::s_isEnabled = false;
+
+static RenderStats& currentStats()
+{
+    static RenderStats stats;
+    return stats;
+}
+
+static RenderStats& lastFrameStats()
+{
+    static RenderStats stats;
+    return stats;
+}
+
+RenderStats::RenderStats()
+{
+    reset();
+}
+
+void RenderStats::reset()
+{
+    itemsCreated = 0;
+    itemsReused = 0;
+    layoutsComputed = 0;
+    layoutsShared = 0;
+    invalidations = 0;
+    memset(invalidationReasons, 0, sizeof(invalidationReasons));
+    validateTime = 0;
+    layoutTime = 0;
+    drawTime = 0;
+}
+
+QString RenderStats::toString() const
+{
+    QStringList lines;
+    lines << QString("items: %1 created, %2 reused").arg(itemsCreated).arg(itemsReused);
+    lines << QString("layouts: %1 computed, %2 shared").arg(layoutsComputed).arg(layoutsShared);
+    lines << QString("time: validate %1 ms, layout %2 ms, draw %3 ms")
+             .arg(validateTime / 1.e6, 0, 'f', 2)
+             .arg(layoutTime / 1.e6, 0, 'f', 2)
+             .arg(drawTime / 1.e6, 0, 'f', 2);
+
+    QStringList reasons;
+    for (int i = 0; i < changeReasonsCount; ++i)
+    {
+        if (invalidationReasons[i] > 0)
+            reasons << QString("%1 %2").arg(changeReasonNames[i]).arg(invalidationReasons[i]);
+    }
+    lines << QString("invalidations: %1 (%2)").arg(invalidations).arg(reasons.join(", "));
+
+    return lines.join("\n");
+}
+
+void RenderStats::setEnabled(bool enabled)
+{
+    if (s_isEnabled == enabled)
+        return;
+
+    s_isEnabled = enabled;
+    currentStats().reset();
+    lastFrameStats().reset();
+}
+
+RenderStats& RenderStats::current()
+{
+    return currentStats();
+}
+
+const RenderStats& RenderStats::lastFrame()
+{
+    return lastFrameStats();
+}
+
+void RenderStats::endFrame()
+{
+    if (!s_isEnabled)
+        return;
+
+    lastFrameStats() = currentStats();
+    currentStats().reset();
+}
+
+void RenderStats::countInvalidation(ChangeReason reason)
+{
+    if (!s_isEnabled)
+        return;
+
+    RenderStats& stats = currentStats();
+    ++stats.invalidations;
+
+    for (int i = 0; i < changeReasonsCount; ++i)
+    {
+        if (reason & ChangeReasonFlag(1 << i))
+            ++stats.invalidationReasons[i];
+    }
+}
+
+} // end namespace Qi
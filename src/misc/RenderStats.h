@@ -0,0 +1,101 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef QI_RENDER_STATS_H
+#define QI_RENDER_STATS_H
+
+#include "QiAPI.h"
+#include <QElapsedTimer>
+#include <QString>
+
+namespace Qi
+{
+
+// per-frame counters of the render pipeline
+// counters are collected in GUI thread only when enabled
+class QI_EXPORT RenderStats
+{
+public:
+    RenderStats();
+
+    void reset();
+    QString toString() const;
+
+    // cache items created by factories
+    int itemsCreated;
+    // cache items moved, prefetched or retained instead of creation
+    int itemsReused;
+    // layouts calculated by views
+    int layoutsComputed;
+    // layouts taken from shared layouts
+    int layoutsShared;
+    // cache invalidations and reasons (per ChangeReasonFlag bit)
+    int invalidations;
+    int invalidationReasons[32];
+
+    // times in nanoseconds (draw time includes lazy validation)
+    qint64 validateTime;
+    qint64 layoutTime;
+    qint64 drawTime;
+
+    static bool isEnabled() { return s_isEnabled; }
+    static void setEnabled(bool enabled);
+
+    // counters of the frame in progress
+    static RenderStats& current();
+    // counters of the last finished frame
+    static const RenderStats& lastFrame();
+    // finishes frame in progress
+    static void endFrame();
+
+    static void count(int RenderStats::* counter, int value = 1)
+    {
+        if (s_isEnabled)
+            current().*counter += value;
+    }
+
+    static void countInvalidation(ChangeReason reason);
+
+private:
+    static bool s_isEnabled;
+};
+
+// adds scope time to the counter if stats are enabled
+class QI_EXPORT RenderStatsTimer
+{
+    Q_DISABLE_COPY(RenderStatsTimer)
+
+public:
+    explicit RenderStatsTimer(qint64 RenderStats::* counter)
+        : m_counter(RenderStats::isEnabled() ? counter : nullptr)
+    {
+        if (m_counter)
+            m_timer.start();
+    }
+
+    ~RenderStatsTimer()
+    {
+        if (m_counter && RenderStats::isEnabled())
+            RenderStats::current().*m_counter += m_timer.nsecsElapsed();
+    }
+
+private:
+    qint64 RenderStats::* m_counter;
+    QElapsedTimer m_timer;
+};
+
+} // end namespace Qi
+
+#endif // QI_RENDER_STATS_H
@@ -0,0 +1,212 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "StylePixmapCache.h"
+#include <QCache>
+#include <QCoreApplication>
+#include <QPainter>
+#include <QPixmap>
+#include <QSet>
+#include <QStyleOption>
+#include <QThread>
+#include <QtMath>
+
+namespace Qi
+{
+
+struct StylePixmapKey
+{
+    const QStyle* style;
+    int kind;
+    int element;
+    quint32 state;
+    int direction;
+    QSize size;
+    qint64 paletteKey;
+    qreal pixelRatio;
+    quint64 extraKey;
+    QString extraText;
+    qint64 iconKey;
+};
+
+static bool operator==(const StylePixmapKey& left, const StylePixmapKey& right)
+{
+    return (left.style == right.style) && (left.kind == right.kind) && (left.element == right.element)
+            && (left.state == right.state) && (left.direction == right.direction) && (left.size == right.size)
+            && (left.paletteKey == right.paletteKey) && (left.pixelRatio == right.pixelRatio) && (left.extraKey == right.extraKey)
+            && (left.iconKey == right.iconKey) && (left.extraText == right.extraText);
+}
+
+static uint qHash(const StylePixmapKey& key)
+{
+    uint hash = ::qHash(quintptr(key.style));
+    hash = hash * 31 + uint(key.kind * 1024 + key.element);
+    hash = hash * 31 + key.state;
+    hash = hash * 31 + uint(key.direction);
+    hash = hash * 31 + uint(key.size.width() * 4099 + key.size.height());
+    hash = hash * 31 + ::qHash(key.paletteKey);
+    hash = hash * 31 + ::qHash(key.pixelRatio);
+    hash = hash * 31 + ::qHash(key.extraKey);
+    hash = hash * 31 + ::qHash(key.extraText);
+    hash = hash * 31 + ::qHash(key.iconKey);
+    return hash;
+}
+
+// larger elements are drawn directly
+static const int MaxPixmapArea = 512 * 512;
+
+static QCache<StylePixmapKey, QPixmap>& pixmaps()
+{
+    // cost in kilobytes
+    static QCache<StylePixmapKey, QPixmap> cache(4 * 1024);
+    return cache;
+}
+
+// styles with cached pixmaps
+static QSet<const QObject*>& trackedStyles()
+{
+    static QSet<const QObject*> styles;
+    return styles;
+}
+
+// the address of a deleted style can be reused by a new one
+static void removeStylePixmaps(QObject* style)
+{
+    auto& cache = pixmaps();
+    for (const auto& key : cache.keys())
+    {
+        if (static_cast<const QObject*>(key.style) == style)
+            cache.remove(key);
+    }
+
+    trackedStyles().remove(style);
+}
+
+bool StylePixmapCache::s_isEnabled = true;
+
+void StylePixmapCache::setEnabled(bool enabled)
+{
+    s_isEnabled = enabled;
+
+    if (!s_isEnabled)
+        clear();
+}
+
+int StylePixmapCache::maxSize()
+{
+    return pixmaps().maxCost();
+}
+
+void StylePixmapCache::setMaxSize(int kbytes)
+{
+    Q_ASSERT(kbytes >= 0);
+    pixmaps().setMaxCost(kbytes);
+}
+
+void StylePixmapCache::clear()
+{
+    pixmaps().clear();
+}
+
+void StylePixmapCache::drawHeaderSection(QStyle* style, const QStyleOptionHeader& option, QPainter* painter, const QWidget* widget)
+{
+    // enum fields are small, section index takes the rest
+    quint64 extraKey = quint64(option.orientation)
+            | (quint64(option.position) << 2)
+            | (quint64(option.selectedPosition) << 5)
+            | (quint64(option.sortIndicator) << 8)
+            | (quint64(quint16(option.textAlignment)) << 10)
+            | (quint64(quint16(option.iconAlignment)) << 26)
+            | (quint64(quint32(option.section)) << 42);
+
+    draw(style, ControlKind, QStyle::CE_HeaderSection, option, extraKey, painter, [style, &option, widget](QPainter* pixmapPainter, const QRect& rect) {
+        QStyleOptionHeader pixmapOption(option);
+        pixmapOption.rect = rect;
+        style->drawControl(QStyle::CE_HeaderSection, &pixmapOption, pixmapPainter, widget);
+    }, option.text, option.icon.cacheKey());
+}
+
+void StylePixmapCache::draw(QStyle* style, ElementKind kind, int element, const QStyleOption& option, quint64 extraKey, QPainter* painter, const std::function<void(QPainter*, const QRect&)>& render, const QString& extraText, qint64 iconKey)
+{
+    Q_ASSERT(style);
+    Q_ASSERT(painter);
+
+    const QRect& rect = option.rect;
+    if (rect.isEmpty())
+        return;
+
+    qreal pixelRatio = painter->device()->devicePixelRatioF();
+    QSize pixmapSize(qCeil(rect.width() * pixelRatio), qCeil(rect.height() * pixelRatio));
+
+    // QPixmap and the cache are not thread safe
+    QCoreApplication* application = QCoreApplication::instance();
+    bool isGuiThread = application && (QThread::currentThread() == application->thread());
+
+    // style sheet rules depend on the widget which is not part of the key
+    bool isWidgetDependent = style->inherits("QStyleSheetStyle");
+
+    if (!s_isEnabled || !isGuiThread || isWidgetDependent || (pixmapSize.width() * pixmapSize.height() > MaxPixmapArea))
+    {
+        render(painter, rect);
+        return;
+    }
+
+    StylePixmapKey key;
+    key.style = style;
+    key.kind = kind;
+    key.element = element;
+    key.state = quint32(option.state);
+    key.direction = option.direction;
+    key.size = rect.size();
+    key.paletteKey = option.palette.cacheKey();
+    key.pixelRatio = pixelRatio;
+    key.extraKey = extraKey;
+    key.extraText = extraText;
+    key.iconKey = iconKey;
+
+    auto& cache = pixmaps();
+    QPixmap* pixmap = cache.object(key);
+    if (!pixmap)
+    {
+        pixmap = new QPixmap(pixmapSize);
+        pixmap->setDevicePixelRatio(pixelRatio);
+        pixmap->fill(Qt::transparent);
+
+        {
+            QPainter pixmapPainter(pixmap);
+            pixmapPainter.setRenderHints(painter->renderHints());
+            render(&pixmapPainter, QRect(QPoint(0, 0), rect.size()));
+        }
+
+        if (!trackedStyles().contains(style))
+        {
+            trackedStyles().insert(style);
+            QObject::connect(style, &QObject::destroyed, &removeStylePixmaps);
+        }
+
+        // insert deletes the pixmap if it doesn't fit
+        QPixmap drawPixmap = *pixmap;
+        int cost = qMax(1, pixmapSize.width() * pixmapSize.height() * 4 / 1024);
+        cache.insert(key, pixmap, cost);
+
+        painter->drawPixmap(rect.topLeft(), drawPixmap);
+        return;
+    }
+
+    painter->drawPixmap(rect.topLeft(), *pixmap);
+}
+
+} // end namespace Qi
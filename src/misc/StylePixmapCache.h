@@ -0,0 +1,86 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef QI_STYLE_PIXMAP_CACHE_H
+#define QI_STYLE_PIXMAP_CACHE_H
+
+#include "QiAPI.h"
+#include <QStyle>
+#include <functional>
+
+class QStyleOptionHeader;
+
+namespace Qi
+{
+
+// renders style primitives and controls once per
+// (style, element, state, size, palette, device pixel ratio)
+// and draws them from pixmaps later
+// pixmaps are GUI thread only, other threads draw directly
+// style sheet styles are drawn directly, their look depends on the widget
+class QI_EXPORT StylePixmapCache
+{
+public:
+    static bool isEnabled() { return s_isEnabled; }
+    static void setEnabled(bool enabled);
+
+    // maximum size of cached pixmaps in kilobytes
+    static int maxSize();
+    static void setMaxSize(int kbytes);
+
+    // removes all pixmaps
+    // style and palette changes don't need it, they are part of the key
+    static void clear();
+
+    // extraKey distinguishes option fields not covered by the key (orientation, sort indicator and so on)
+    template <typename Option>
+    static void drawPrimitive(QStyle* style, QStyle::PrimitiveElement element, const Option& option, QPainter* painter, const QWidget* widget, quint64 extraKey = 0)
+    {
+        draw(style, PrimitiveKind, element, option, extraKey, painter, [style, element, &option, widget](QPainter* pixmapPainter, const QRect& rect) {
+            Option pixmapOption(option);
+            pixmapOption.rect = rect;
+            style->drawPrimitive(element, &pixmapOption, pixmapPainter, widget);
+        });
+    }
+
+    template <typename Option>
+    static void drawControl(QStyle* style, QStyle::ControlElement element, const Option& option, QPainter* painter, const QWidget* widget, quint64 extraKey = 0)
+    {
+        draw(style, ControlKind, element, option, extraKey, painter, [style, element, &option, widget](QPainter* pixmapPainter, const QRect& rect) {
+            Option pixmapOption(option);
+            pixmapOption.rect = rect;
+            style->drawControl(element, &pixmapOption, pixmapPainter, widget);
+        });
+    }
+
+    // CE_HeaderSection keyed by all header fields (position, text, icon and so on)
+    static void drawHeaderSection(QStyle* style, const QStyleOptionHeader& option, QPainter* painter, const QWidget* widget);
+
+private:
+    enum ElementKind
+    {
+        PrimitiveKind,
+        ControlKind
+    };
+
+    static void draw(QStyle* style, ElementKind kind, int element, const QStyleOption& option, quint64 extraKey, QPainter* painter, const std::function<void(QPainter*, const QRect&)>& render, const QString& extraText = QString(), qint64 iconKey = 0);
+
+    static bool s_isEnabled;
+};
+
+} // end namespace Qi
+
+#endif // QI_STYLE_PIXMAP_CACHE_H
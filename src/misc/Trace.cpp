@@ -0,0 +1,154 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "Trace.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutex>
+#include <QThread>
+#include <QVector>
+
+namespace Qi
+{
+
+struct TraceEvent
+{
+    const char* name;
+    const char* category;
+    qint64 start;
+    qint64 duration;
+    quintptr threadId;
+};
+
+struct TraceData
+{
+    QMutex mutex;
+    QString fileName;
+    QElapsedTimer clock;
+    // ring of the last maxEvents events
+    QVector<TraceEvent> events;
+    int maxEvents;
+    // oldest event position once ring is full
+    int nextEvent;
+};
+
+static TraceData& traceData()
+{
+    static TraceData data;
+    return data;
+}
+
+std::atomic<bool> Trace::s_isActive(false);
+
+bool Trace::start(const QString& fileName, int maxEvents)
+{
+    Q_ASSERT(maxEvents > 0);
+
+    TraceData& data = traceData();
+    QMutexLocker locker(&data.mutex);
+
+    if (isActive())
+        return false;
+
+    data.fileName = fileName;
+    data.events.clear();
+    data.maxEvents = maxEvents;
+    data.nextEvent = 0;
+    data.clock.start();
+    s_isActive.store(true);
+
+    return true;
+}
+
+bool Trace::stop()
+{
+    TraceData& data = traceData();
+
+    // take events and write them without blocking traced threads
+    QString fileName;
+    QVector<TraceEvent> events;
+    int firstEvent = 0;
+    {
+        QMutexLocker locker(&data.mutex);
+
+        if (!isActive())
+            return false;
+
+        s_isActive.store(false);
+
+        fileName = data.fileName;
+        events.swap(data.events);
+        firstEvent = data.nextEvent;
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    qint64 pid = QCoreApplication::applicationPid();
+
+    file.write("{\"traceEvents\":[\n");
+    for (int i = 0; i < events.size(); ++i)
+    {
+        // oldest event first
+        const TraceEvent& event = events[(firstEvent + i) % events.size()];
+        // timestamps are in microseconds
+        QByteArray line = QString("{\"name\":\"%1\",\"cat\":\"%2\",\"ph\":\"X\",\"ts\":%3,\"dur\":%4,\"pid\":%5,\"tid\":%6}")
+                .arg(event.name)
+                .arg(event.category)
+                .arg(event.start / 1.e3, 0, 'f', 3)
+                .arg(event.duration / 1.e3, 0, 'f', 3)
+                .arg(pid)
+                .arg(event.threadId)
+                .toUtf8();
+
+        if (i + 1 < events.size())
+            line += ",\n";
+
+        file.write(line);
+    }
+    file.write("\n],\"displayTimeUnit\":\"ms\"}\n");
+
+    return true;
+}
+
+qint64 Trace::now()
+{
+    return traceData().clock.nsecsElapsed();
+}
+
+void Trace::addEvent(const char* name, const char* category, qint64 start, qint64 duration)
+{
+    TraceData& data = traceData();
+    QMutexLocker locker(&data.mutex);
+
+    // trace has been stopped inside the scope
+    if (!isActive())
+        return;
+
+    TraceEvent event = { name, category, start, duration, quintptr(QThread::currentThreadId()) };
+    if (data.events.size() < data.maxEvents)
+    {
+        data.events.append(event);
+        return;
+    }
+
+    // overwrite the oldest event
+    data.events[data.nextEvent] = event;
+    data.nextEvent = (data.nextEvent + 1) % data.maxEvents;
+}
+
+} // end namespace Qi
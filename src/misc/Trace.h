@@ -0,0 +1,76 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef QI_TRACE_H
+#define QI_TRACE_H
+
+#include "QiAPI.h"
+#include <QString>
+#include <atomic>
+
+namespace Qi
+{
+
+// collects scoped hot-path events and writes them
+// in Chrome Trace Event JSON format (chrome://tracing, Perfetto)
+class QI_EXPORT Trace
+{
+public:
+    static bool isActive() { return s_isActive.load(std::memory_order_relaxed); }
+
+    // starts collecting events to be written into fileName
+    // only last maxEvents events are kept in long sessions
+    static bool start(const QString& fileName, int maxEvents = 1000000);
+    // stops collecting and writes events into the file
+    static bool stop();
+
+    // returns nanoseconds since trace start
+    static qint64 now();
+    // adds complete event, can be called from any thread
+    static void addEvent(const char* name, const char* category, qint64 start, qint64 duration);
+
+private:
+    static std::atomic<bool> s_isActive;
+};
+
+// adds scope duration event if trace is active
+// name and category should be string literals
+class QI_EXPORT TraceScope
+{
+    Q_DISABLE_COPY(TraceScope)
+
+public:
+    TraceScope(const char* name, const char* category)
+        : m_name(Trace::isActive() ? name : nullptr),
+          m_category(category),
+          m_start(m_name ? Trace::now() : 0)
+    {
+    }
+
+    ~TraceScope()
+    {
+        if (m_name && Trace::isActive())
+            Trace::addEvent(m_name, m_category, m_start, Trace::now() - m_start);
+    }
+
+private:
+    const char* m_name;
+    const char* m_category;
+    qint64 m_start;
+};
+
+} // end namespace Qi
+
+#endif // QI_TRACE_H
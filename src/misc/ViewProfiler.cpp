@@ -0,0 +1,275 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "ViewProfiler.h"
+#include "core/View.h"
+#include <QHash>
+#include <QPointer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStringList>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <typeinfo>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#include <cstdlib>
+#endif
+
+namespace Qi
+{
+
+static const char* operationNames[ViewProfiler::OperationCount] = { "draw", "size", "layout", "schemaDraw" };
+
+struct ClassEntries
+{
+    ViewProfiler::Entry operations[ViewProfiler::OperationSchemaDraw];
+};
+
+struct SchemaEntry
+{
+    // detects deleted view which address is reused by other view
+    QPointer<const View> view;
+    QByteArray typeName;
+    quintptr address;
+    ViewProfiler::Entry entry;
+
+    SchemaEntry(): address(0) {}
+};
+
+struct ProfileData
+{
+    // by typeid name of the view class
+    // name pointers are not unique across shared libraries
+    QHash<QByteArray, ClassEntries> classes;
+    // by root view of the schema
+    QHash<const View*, SchemaEntry> schemas;
+    // schemas of deleted views
+    QVector<SchemaEntry> deletedSchemas;
+};
+
+static ProfileData& profileData()
+{
+    static ProfileData data;
+    return data;
+}
+
+static QString className(const QByteArray& typeName)
+{
+    QString name = QString::fromLatin1(typeName);
+
+#if defined(__GNUG__)
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(typeName.constData(), nullptr, nullptr, &status);
+    if (demangled)
+    {
+        if (status == 0)
+            name = QString::fromLatin1(demangled);
+        free(demangled);
+    }
+#endif
+
+    name.remove("Qi::");
+    name.remove("class ");
+    return name;
+}
+
+static int bucketIndex(qint64 time)
+{
+    if (time <= 1)
+        return 0;
+
+    // 4 buckets per power of two
+    return qBound(0, int(std::log2(double(time)) * 4), ViewProfiler::BucketsCount - 1);
+}
+
+static qint64 bucketUpperTime(int index)
+{
+    return qint64(std::exp2((index + 1) / 4.));
+}
+
+bool ViewProfiler::s_isEnabled = false;
+
+ViewProfiler::Entry::Entry()
+    : calls(0),
+      totalTime(0),
+      maxTime(0)
+{
+    memset(buckets, 0, sizeof(buckets));
+}
+
+void ViewProfiler::Entry::add(qint64 time)
+{
+    ++calls;
+    totalTime += time;
+    maxTime = qMax(maxTime, time);
+    ++buckets[bucketIndex(time)];
+}
+
+qint64 ViewProfiler::Entry::percentile(double percentile) const
+{
+    if (calls == 0)
+        return 0;
+
+    qint64 threshold = qint64(std::ceil(calls * percentile));
+    qint64 count = 0;
+    for (int i = 0; i < BucketsCount; ++i)
+    {
+        count += buckets[i];
+        if (count >= threshold)
+            return qMin(bucketUpperTime(i), maxTime);
+    }
+
+    return maxTime;
+}
+
+void ViewProfiler::setEnabled(bool enabled)
+{
+    s_isEnabled = enabled;
+}
+
+void ViewProfiler::reset()
+{
+    profileData().classes.clear();
+    profileData().schemas.clear();
+    profileData().deletedSchemas.clear();
+}
+
+void ViewProfiler::record(const View* view, Operation operation, qint64 time)
+{
+    Q_ASSERT(view);
+    Q_ASSERT(operation >= 0 && operation < OperationCount);
+
+    ProfileData& data = profileData();
+    // lookup without copying the name
+    QByteArray typeName = QByteArray::fromRawData(typeid(*view).name(), int(strlen(typeid(*view).name())));
+
+    if (operation == OperationSchemaDraw)
+    {
+        auto it = data.schemas.find(view);
+        if (it != data.schemas.end() && it.value().view.isNull())
+        {
+            // view has been deleted and its address is reused
+            data.deletedSchemas.append(it.value());
+            data.schemas.erase(it);
+            it = data.schemas.end();
+        }
+
+        if (it == data.schemas.end())
+        {
+            SchemaEntry schemaEntry;
+            schemaEntry.view = view;
+            schemaEntry.typeName = QByteArray(typeName.constData(), typeName.size());
+            schemaEntry.address = quintptr(view);
+            it = data.schemas.insert(view, schemaEntry);
+        }
+
+        it.value().entry.add(time);
+    }
+    else
+    {
+        auto it = data.classes.find(typeName);
+        if (it == data.classes.end())
+            it = data.classes.insert(QByteArray(typeName.constData(), typeName.size()), ClassEntries());
+
+        it.value().operations[operation].add(time);
+    }
+}
+
+struct DumpRow
+{
+    QString name;
+    const char* operation;
+    const ViewProfiler::Entry* entry;
+};
+
+static QVector<DumpRow> dumpRows()
+{
+    QVector<DumpRow> rows;
+
+    const ProfileData& data = profileData();
+    for (auto it = data.classes.begin(); it != data.classes.end(); ++it)
+    {
+        QString name = className(it.key());
+        for (int operation = 0; operation < ViewProfiler::OperationSchemaDraw; ++operation)
+        {
+            const auto& entry = it.value().operations[operation];
+            if (entry.calls > 0)
+                rows.append({name, operationNames[operation], &entry});
+        }
+    }
+
+    auto addSchemaRow = [&rows](const SchemaEntry& schemaEntry, bool isDeleted) {
+        QString name = QString("%1@0x%2").arg(className(schemaEntry.typeName)).arg(schemaEntry.address, 0, 16);
+        if (isDeleted)
+            name += " (deleted)";
+        rows.append({name, operationNames[ViewProfiler::OperationSchemaDraw], &schemaEntry.entry});
+    };
+
+    for (const auto& schemaEntry: data.schemas)
+        addSchemaRow(schemaEntry, schemaEntry.view.isNull());
+
+    for (const auto& schemaEntry: data.deletedSchemas)
+        addSchemaRow(schemaEntry, true);
+
+    std::sort(rows.begin(), rows.end(), [](const DumpRow& left, const DumpRow& right) {
+        return left.entry->totalTime > right.entry->totalTime;
+    });
+
+    return rows;
+}
+
+QString ViewProfiler::dumpTable()
+{
+    QStringList lines;
+    lines << QString("%1 %2 %3 %4 %5 %6")
+             .arg("view", -40).arg("operation", -10).arg("calls", 10)
+             .arg("total ms", 12).arg("max us", 10).arg("p99 us", 10);
+
+    for (const auto& row: dumpRows())
+    {
+        lines << QString("%1 %2 %3 %4 %5 %6")
+                 .arg(row.name, -40).arg(row.operation, -10).arg(row.entry->calls, 10)
+                 .arg(row.entry->totalTime / 1.e6, 12, 'f', 3)
+                 .arg(row.entry->maxTime / 1.e3, 10, 'f', 1)
+                 .arg(row.entry->percentile(0.99) / 1.e3, 10, 'f', 1);
+    }
+
+    return lines.join("\n");
+}
+
+QByteArray ViewProfiler::dumpJson()
+{
+    QJsonArray entries;
+
+    for (const auto& row: dumpRows())
+    {
+        QJsonObject entry;
+        entry["view"] = row.name;
+        entry["operation"] = QString::fromLatin1(row.operation);
+        entry["calls"] = double(row.entry->calls);
+        entry["totalNs"] = double(row.entry->totalTime);
+        entry["maxNs"] = double(row.entry->maxTime);
+        entry["p99Ns"] = double(row.entry->percentile(0.99));
+        entries.append(entry);
+    }
+
+    return QJsonDocument(entries).toJson();
+}
+
+} // end namespace Qi
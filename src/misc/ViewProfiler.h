@@ -0,0 +1,103 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef QI_VIEW_PROFILER_H
+#define QI_VIEW_PROFILER_H
+
+#include "QiAPI.h"
+#include <QElapsedTimer>
+#include <QString>
+
+namespace Qi
+{
+
+class View;
+
+// opt-in profiler of View calls
+// aggregates costs per concrete View class and per item schema
+// times include nested sub-views calls
+class QI_EXPORT ViewProfiler
+{
+public:
+    enum Operation
+    {
+        OperationDraw,
+        OperationSize,
+        OperationLayout,
+        // draw of whole item schema (per root view instance)
+        OperationSchemaDraw,
+        OperationCount
+    };
+
+    static const int BucketsCount = 160;
+
+    struct QI_EXPORT Entry
+    {
+        Entry();
+
+        qint64 calls;
+        qint64 totalTime;
+        qint64 maxTime;
+        // log-scaled histogram of call times
+        int buckets[BucketsCount];
+
+        void add(qint64 time);
+        // approximate percentile time (percentile in [0, 1])
+        qint64 percentile(double percentile) const;
+    };
+
+    static bool isEnabled() { return s_isEnabled; }
+    static void setEnabled(bool enabled);
+    static void reset();
+
+    static void record(const View* view, Operation operation, qint64 time);
+
+    // dumps aggregated data sorted by total time
+    static QString dumpTable();
+    static QByteArray dumpJson();
+
+private:
+    static bool s_isEnabled;
+};
+
+// records scope time of the view call if profiler is enabled
+class QI_EXPORT ViewProfilerScope
+{
+    Q_DISABLE_COPY(ViewProfilerScope)
+
+public:
+    ViewProfilerScope(const View* view, ViewProfiler::Operation operation)
+        : m_view(ViewProfiler::isEnabled() ? view : nullptr),
+          m_operation(operation)
+    {
+        if (m_view)
+            m_timer.start();
+    }
+
+    ~ViewProfilerScope()
+    {
+        if (m_view)
+            ViewProfiler::record(m_view, m_operation, m_timer.nsecsElapsed());
+    }
+
+private:
+    const View* m_view;
+    ViewProfiler::Operation m_operation;
+    QElapsedTimer m_timer;
+};
+
+} // end namespace Qi
+
+#endif // QI_VIEW_PROFILER_H
@@ -48,6 +48,7 @@ SOURCES += QiAPI.cpp \
     items/button/Button.cpp \
     items/image/StyleStandardPixmap.cpp \
     items/selection/SelectionIterators.cpp \
+    items/selection/SelectionCopy.cpp \
     items/image/Pixmap.cpp \
     items/image/Image.cpp \
     items/link/Link.cpp \
@@ -77,11 +78,21 @@ SOURCES += QiAPI.cpp \
     widgets/SceneWidget.cpp \
     cache/space/CacheSpaceScene.cpp \
     items/rating/Rating.cpp \
-    utils/PainterState.cpp
+    utils/PainterState.cpp \
+    cache/CacheLayouts.cpp \
+    misc/CacheSpaceBackingStore.cpp \
+    misc/RenderStats.cpp \
+    misc/ViewProfiler.cpp \
+    misc/Trace.cpp \
+    misc/StylePixmapCache.cpp \
+    misc/GridLinesBatch.cpp \
+    misc/GridRenderer.cpp \
+    misc/GridTextExporter.cpp
 
 HEADERS +=  QiAPI.h \
     utils/Signal.h \
     core/ItemID.h \
+    core/ChangedItems.h \
     core/Range.h \
     core/ext/Ranges.h \
     core/Layout.h \
@@ -103,11 +114,15 @@ HEADERS +=  QiAPI.h \
     cache/space/CacheSpace.h \
     cache/space/CacheSpaceGrid.h \
     utils/auto_value.h \
+    utils/RingBufferMPSC.h \
+    utils/MemoryUsage.h \
+    utils/VectorEdit.h \
     cache/space/CacheSpaceItem.h \
     core/ext/ViewComposite.h \
     core/ext/ModelTyped.h \
     core/ItemsIterator.h \
     core/ext/ModelStore.h \
+    core/ext/ModelStoreChannel.h \
     core/ext/ModelCallback.h \
     core/ext/ModelConversion.h \
     items/cache/ViewCacheSpace.h \
@@ -125,6 +140,7 @@ HEADERS +=  QiAPI.h \
     items/button/Button.h \
     items/image/StyleStandardPixmap.h \
     items/selection/SelectionIterators.h \
+    items/selection/SelectionCopy.h \
     items/image/Pixmap.h \
     items/image/Image.h \
     items/link/Link.h \
@@ -156,7 +172,16 @@ HEADERS +=  QiAPI.h \
     widgets/SceneWidget.h \
     cache/space/CacheSpaceScene.h \
     items/rating/Rating.h \
-    utils/PainterState.h
+    utils/PainterState.h \
+    cache/CacheLayouts.h \
+    misc/CacheSpaceBackingStore.h \
+    misc/RenderStats.h \
+    misc/ViewProfiler.h \
+    misc/Trace.h \
+    misc/StylePixmapCache.h \
+    misc/GridLinesBatch.h \
+    misc/GridRenderer.h \
+    misc/GridTextExporter.h
 
 win32 {
     TARGET_EXT = .dll
@@ -15,15 +15,25 @@
 */
 
 #include "Lines.h"
+#include "misc/Trace.h"
+#include "utils/MemoryUsage.h"
+#include "utils/VectorEdit.h"
+#include <algorithm>
 
 namespace Qi
 {
 
 static const int DefaultLineSize = 0;
 static const bool DefaultLineVisibility = true;
+// lines with non-dominant size are kept as exceptions
+// while there are less than one per MaxSizeExceptionsRatio lines
+static const int MaxSizeExceptionsRatio = 16;
 
 Lines::Lines(int count)
-    : m_count(0)
+    : m_count(0),
+      m_isSizesValid(false),
+      m_uniformLineSize(InvalidIndex),
+      m_visibleSize(0)
 {
     setCount(count);
 }
@@ -36,7 +46,11 @@ Lines::Lines(const Lines& lines)
       m_relative2absolute(lines.m_relative2absolute),
       m_visible2absolute(lines.m_visible2absolute),
       m_absolute2visible(lines.m_absolute2visible),
-      m_visibleLinesSizes(lines.m_visibleLinesSizes)
+      m_visibleLinesSizes(lines.m_visibleLinesSizes),
+      m_isSizesValid(lines.m_isSizesValid),
+      m_uniformLineSize(lines.m_uniformLineSize),
+      m_sizeExceptions(lines.m_sizeExceptions),
+      m_visibleSize(lines.m_visibleSize)
 {
 }
 
@@ -172,22 +186,104 @@ int Lines::moveVisibleLines(int oldLine, int newLine, int linesCount)
 
 int Lines::insertVisibleLines(int lineBefore, int linesCount)
 {
-    bool justAppend = lineBefore >= count();
+    Q_ASSERT(linesCount > 0);
+
+    int relativeLineBefore = (lineBefore < visibleCount()) ? toRelative(toAbsolute(lineBefore)) : m_count;
+
+    // new absolute lines are appended
+    int firstLine = m_count;
+    insertLinesImpl(firstLine, linesCount, relativeLineBefore);
+
+    return toVisible(firstLine);
+}
+
+void Lines::removeLines(const QVector<int>& lines)
+{
+    QVector<int> removedLines = lines;
+    std::sort(removedLines.begin(), removedLines.end());
+    removedLines.erase(std::unique(removedLines.begin(), removedLines.end()), removedLines.end());
+
+    Q_ASSERT(removedLines.isEmpty() || (removedLines.front() >= 0 && removedLines.back() < m_count));
+    if (removedLines.isEmpty())
+        return;
 
-    // append
-    setCount(count() + linesCount);
+    // compact per-line data
+    if (m_linesSize.size() > 1)
+        removeValues(m_linesSize, removedLines);
+    if (m_linesVisible.size() > 1)
+        removeValues(m_linesVisible, removedLines);
 
-    if (justAppend)
+    // drop removed lines from permutation and shift the rest absolute lines
+    int write = 0;
+    for (int absoluteLine: m_relative2absolute)
     {
-        return visibleCount() - linesCount;
+        auto it = std::lower_bound(removedLines.begin(), removedLines.end(), absoluteLine);
+        if (it != removedLines.end() && *it == absoluteLine)
+            continue;
+
+        m_relative2absolute[write++] = absoluteLine - (int)std::distance(removedLines.begin(), it);
     }
-    else
+    m_relative2absolute.resize(write);
+
+    m_count -= removedLines.size();
+    Q_ASSERT(m_count == m_relative2absolute.size());
+
+    invalidateVisibles();
+
+    emit linesRemoved(this, removedLines);
+    emit linesChanged(this, ChangeReasonLinesCount|ChangeReasonLinesCountWeak);
+}
+
+void Lines::insertLines(int lineBefore, int linesCount)
+{
+    Q_ASSERT(lineBefore >= 0 && lineBefore <= m_count);
+    Q_ASSERT(linesCount > 0);
+
+    lineBefore = qBound(0, lineBefore, m_count);
+    int relativeLineBefore = (lineBefore < m_count) ? toRelative(lineBefore) : m_count;
+    insertLinesImpl(lineBefore, linesCount, relativeLineBefore);
+}
+
+int Lines::toRelative(int absoluteLine) const
+{
+    return (int)std::distance(m_relative2absolute.begin(), std::find(m_relative2absolute.begin(), m_relative2absolute.end(), absoluteLine));
+}
+
+void Lines::insertLinesImpl(int lineBefore, int linesCount, int relativeLineBefore)
+{
+    if (linesCount <= 0)
+        return;
+
+    // store of a single line may be per-line data compacted by removeLines,
+    // keep it per-line so the new lines don't take it's value
+    bool isSingleLine = (m_count == 1);
+
+    // new lines have default size and visibility
+    if (m_linesSize.size() > 1 || (isSingleLine && m_linesSize.size() == 1))
+        insertValues(m_linesSize, lineBefore, linesCount, DefaultLineSize);
+    if (m_linesVisible.size() > 1 || (isSingleLine && m_linesVisible.size() == 1))
+        insertValues(m_linesVisible, lineBefore, linesCount, DefaultLineVisibility);
+
+    // shift absolute lines and insert new ones into permutation
+    for (int& absoluteLine: m_relative2absolute)
     {
-        return moveVisibleLines(visibleCount() - linesCount, lineBefore, linesCount);
+        if (absoluteLine >= lineBefore)
+            absoluteLine += linesCount;
     }
+
+    m_relative2absolute.insert(relativeLineBefore, linesCount, InvalidIndex);
+    for (int i = 0; i < linesCount; ++i)
+        m_relative2absolute[relativeLineBefore + i] = lineBefore + i;
+
+    m_count += linesCount;
+
+    invalidateVisibles();
+
+    emit linesInserted(this, lineBefore, linesCount);
+    emit linesChanged(this, ChangeReasonLinesCount|ChangeReasonLinesCountWeak);
 }
 
-int Lines::findVisibleIDByPos(int position, bool noTailLine) const
+int Lines::findVisibleIDByPos(qint64 position, bool noTailLine) const
 {
     if (isEmptyVisible())
         return InvalidIndex;
@@ -199,24 +295,29 @@ int Lines::findVisibleIDByPos(int position, bool noTailLine) const
         return noTailLine ? visibleCount() - 1 : visibleCount();
 
     validateSizes();
+    if (m_uniformLineSize != InvalidIndex)
+        return findVisibleIDByPosUniform(position);
+
     return findVisibleIDByPosImpl(position, 0, visibleCount() - 1);
 }
 
-int Lines::findVisibleIDByPos(int position, int fromVisibleLine, int toVisibleLine) const
+int Lines::findVisibleIDByPos(qint64 position, int fromVisibleLine, int toVisibleLine) const
 {
     Q_ASSERT(fromVisibleLine < m_count && toVisibleLine < m_count && fromVisibleLine <= toVisibleLine);
 
     validateSizes();
 
-    if (position < m_visibleLinesSizes[fromVisibleLine])
+    if (position < startPos(fromVisibleLine))
         return InvalidIndex;
-    else if (position > m_visibleLinesSizes[toVisibleLine + 1])
+    else if (position > endPos(toVisibleLine))
         return InvalidIndex;
+    else if (m_uniformLineSize != InvalidIndex)
+        return qBound(fromVisibleLine, findVisibleIDByPosUniform(position), toVisibleLine);
     else
         return findVisibleIDByPosImpl(position, fromVisibleLine, toVisibleLine);
 }
 
-int Lines::findVisibleIDByPosImpl(int position, int fromVisibleLine, int toVisibleLine) const
+int Lines::findVisibleIDByPosImpl(qint64 position, int fromVisibleLine, int toVisibleLine) const
 {
     Q_ASSERT(fromVisibleLine < m_count && toVisibleLine < m_count && fromVisibleLine <= toVisibleLine);
 
@@ -245,11 +346,68 @@ int Lines::findVisibleIDByPosImpl(int position, int fromVisibleLine, int toVisib
     }
 }
 
+int Lines::findVisibleIDByPosUniform(qint64 position) const
+{
+    Q_ASSERT(m_uniformLineSize != InvalidIndex);
+
+    int line = 0;
+    qint64 linePos = 0;
+
+    if (!m_sizeExceptions.empty())
+    {
+        // find last exception line started at or before position
+        auto it = std::upper_bound(m_sizeExceptions.begin(), m_sizeExceptions.end(), position, [this] (qint64 position, const SizeException& exception) {
+            return position < qint64(exception.visibleLine) * m_uniformLineSize + exception.deltaBefore;
+        });
+
+        if (it != m_sizeExceptions.begin())
+        {
+            --it;
+            qint64 exceptionPos = qint64(it->visibleLine) * m_uniformLineSize + it->deltaBefore;
+            if (position < exceptionPos + it->size)
+                return it->visibleLine;
+
+            line = it->visibleLine + 1;
+            linePos = exceptionPos + it->size;
+        }
+    }
+
+    // lines up to the next exception have uniform size
+    if (m_uniformLineSize > 0)
+        line += int(qMin<qint64>((position - linePos) / m_uniformLineSize, m_count));
+
+    return qMin(line, visibleCount() - 1);
+}
+
+qint64 Lines::startPosUniform(int visibleLine) const
+{
+    Q_ASSERT(m_uniformLineSize != InvalidIndex);
+
+    qint64 delta = 0;
+    if (!m_sizeExceptions.empty())
+    {
+        // first exception at or after visibleLine
+        auto it = std::lower_bound(m_sizeExceptions.begin(), m_sizeExceptions.end(), visibleLine, [] (const SizeException& exception, int line) {
+            return exception.visibleLine < line;
+        });
+
+        if (it != m_sizeExceptions.end())
+            delta = it->deltaBefore;
+        else
+            delta = m_sizeExceptions.back().deltaBefore + m_sizeExceptions.back().size - m_uniformLineSize;
+    }
+
+    return qint64(visibleLine) * m_uniformLineSize + delta;
+}
+
 void Lines::validateVisibles() const
 {
     if (!m_absolute2visible.empty())
         return;
 
+    // visibility passes include lines filters
+    TraceScope traceScope("Lines::validateVisibles", "lines,filter");
+
     m_visible2absolute.clear();
     m_absolute2visible.fill(InvalidIndex, m_relative2absolute.size());
     for (int i = 0, count = m_relative2absolute.size(); i < count; ++i)
@@ -265,13 +423,80 @@ void Lines::validateVisibles() const
 
 void Lines::validateSizes() const
 {
-    if (!m_visibleLinesSizes.empty())
+    if (m_isSizesValid)
         return;
 
     validateVisibles();
 
-    int size = 0;
-    m_visibleLinesSizes.resize(visibleCount() + 1);
+    TraceScope traceScope("Lines::validateSizes", "lines");
+
+    m_isSizesValid = true;
+    m_visibleLinesSizes.clear();
+    m_sizeExceptions.clear();
+    m_uniformLineSize = InvalidIndex;
+
+    int count = visibleCount();
+
+    if (m_linesSize.size() <= 1)
+    {
+        // all lines have the same size, positions are computed on the fly
+        m_uniformLineSize = m_linesSize.empty() ? DefaultLineSize : m_linesSize.front();
+        m_visibleSize = qint64(count) * m_uniformLineSize;
+        return;
+    }
+
+    // find dominant size of the visible lines (majority vote)
+    int dominantSize = 0;
+    int votes = 0;
+    for (int line = 0; line < count; ++line)
+    {
+        int size = m_linesSize[toAbsolute(line)];
+        if (votes == 0)
+        {
+            dominantSize = size;
+            votes = 1;
+        }
+        else if (size == dominantSize)
+            ++votes;
+        else
+            --votes;
+    }
+
+    if (dominantSize > 0)
+    {
+        int maxExceptions = count / MaxSizeExceptionsRatio;
+        qint64 delta = 0;
+        bool isFewExceptions = true;
+
+        for (int line = 0; line < count; ++line)
+        {
+            int size = m_linesSize[toAbsolute(line)];
+            if (size == dominantSize)
+                continue;
+
+            if (m_sizeExceptions.size() >= maxExceptions)
+            {
+                isFewExceptions = false;
+                break;
+            }
+
+            SizeException exception = { line, size, delta };
+            m_sizeExceptions.append(exception);
+            delta += size - dominantSize;
+        }
+
+        if (isFewExceptions)
+        {
+            m_uniformLineSize = dominantSize;
+            m_visibleSize = qint64(count) * dominantSize + delta;
+            return;
+        }
+
+        m_sizeExceptions.clear();
+    }
+
+    qint64 size = 0;
+    m_visibleLinesSizes.resize(count + 1);
 
     for (int line = 0; line < m_visibleLinesSizes.size() - 1; ++line)
     {
@@ -279,6 +504,7 @@ void Lines::validateSizes() const
         size += lineSize(toAbsolute(line));
     }
     m_visibleLinesSizes.back() = size;
+    m_visibleSize = size;
 }
 
 
@@ -494,21 +720,27 @@ int Lines::visibleCount() const
     return m_visible2absolute.size();
 }
 
-int Lines::visibleSize() const
+qint64 Lines::visibleSize() const
 {
     validateSizes();
-    return m_visibleLinesSizes.back();
+    return m_visibleSize;
 }
 
-int Lines::startPos(int visibleLine) const
+qint64 Lines::startPos(int visibleLine) const
 {
     validateSizes();
+    if (m_uniformLineSize != InvalidIndex)
+        return startPosUniform(visibleLine);
+
     return m_visibleLinesSizes[visibleLine];
 }
 
-int Lines::endPos(int visibleLine) const
+qint64 Lines::endPos(int visibleLine) const
 {
     validateSizes();
+    if (m_uniformLineSize != InvalidIndex)
+        return startPosUniform(visibleLine + 1);
+
     return m_visibleLinesSizes[visibleLine + 1];
 }
 
@@ -520,4 +752,17 @@ void Lines::setPermutation(const QVector<int>& permutation)
     emit linesChanged(this, ChangeReasonLinesOrder);
 }
 
+qint64 Lines::memoryUsage() const
+{
+    return sizeof(*this) +
+           containerMemory(m_linesSize) +
+           containerMemory(m_linesVisible) +
+           containerMemory(m_relative2absolute) +
+           containerMemory(m_visible2absolute) +
+           containerMemory(m_absolute2visible) +
+           containerMemory(m_visibleLinesSizes) +
+           containerMemory(m_sizeExceptions) +
+           containerMemory(m_linesVisibility);
+}
+
 } // end namespace Qi
@@ -40,7 +40,7 @@ public:
     void setCount(int count);
 
     int visibleCount() const;
-    int visibleSize() const;
+    qint64 visibleSize() const;
 
     bool isEmpty() const { return m_count == 0; }
     bool isEmptyVisible() const { return visibleCount() == 0; }
@@ -68,6 +68,11 @@ public:
     int moveVisibleLines(int oldLine, int newLine, int linesCount = 1);
     int insertVisibleLines(int lineBefore, int linesCount = 1);
 
+    // removes absolute lines and keeps current order of the rest lines
+    void removeLines(const QVector<int>& lines);
+    // inserts absolute lines before lineBefore, new lines precede lineBefore in current order
+    void insertLines(int lineBefore, int linesCount = 1);
+
     int toAbsolute(int visibleLine) const { validateVisibles(); Q_ASSERT(visibleLine >= 0 && visibleLine < m_visible2absolute.size()); return m_visible2absolute[visibleLine]; }
     int toVisible(int absoluteLine) const { validateVisibles(); Q_ASSERT(absoluteLine >= 0 && absoluteLine < m_absolute2visible.size()); return m_absolute2visible[absoluteLine]; }
 
@@ -75,11 +80,12 @@ public:
     int toVisibleSafe(int absoluteLine) const { validateVisibles(); return (absoluteLine < m_absolute2visible.size()) ? m_absolute2visible[absoluteLine] : InvalidIndex; }
 
     // see m_visibleLinesSizes for possible return values
-    int findVisibleIDByPos(int position, bool noTailLine = true) const;
-    int findVisibleIDByPos(int position, int fromVisibleLine, int toVisibleLine) const;
+    int findVisibleIDByPos(qint64 position, bool noTailLine = true) const;
+    int findVisibleIDByPos(qint64 position, int fromVisibleLine, int toVisibleLine) const;
 
-    int startPos(int visibleLine) const;
-    int endPos(int visibleLine) const;
+    // positions are 64-bit to support lines with total size beyond int range
+    qint64 startPos(int visibleLine) const;
+    qint64 endPos(int visibleLine) const;
 
     // pred has less operator - bool operator() (int leftLine, int rightLine) const;
     template <typename Pred> void sort(bool stable, const Pred& pred)
@@ -97,21 +103,32 @@ public:
     const QVector<int>& permutation() const { return m_relative2absolute; }
     void setPermutation(const QVector<int>& permutation);
 
+    // returns approximate memory used by lines in bytes
+    qint64 memoryUsage() const;
+
 signals:
     void linesChanged(const Lines*, ChangeReason);
+    // emitted before linesChanged to let per-line storages compact values
+    // lines - removed absolute lines in ascending order
+    void linesRemoved(const Lines*, const QVector<int>& lines);
+    void linesInserted(const Lines*, int lineBefore, int linesCount);
 
 private:
     Lines(const Lines& lines);
     Lines& operator=(const Lines&);
 
     bool isLineVisibleRaw(int line) const;
+    int toRelative(int absoluteLine) const;
+    void insertLinesImpl(int lineBefore, int linesCount, int relativeLineBefore);
 
-    int findVisibleIDByPosImpl(int position, int fromVisibleLine, int toVisibleLine) const;
+    int findVisibleIDByPosImpl(qint64 position, int fromVisibleLine, int toVisibleLine) const;
+    int findVisibleIDByPosUniform(qint64 position) const;
+    qint64 startPosUniform(int visibleLine) const;
 
     void invalidateVisibles() { m_visible2absolute.clear(); m_absolute2visible.clear(); invalidateSizes(); }
     void validateVisibles() const;
 
-    void invalidateSizes() { m_visibleLinesSizes.clear(); }
+    void invalidateSizes() { m_isSizesValid = false; m_visibleLinesSizes.clear(); m_sizeExceptions.clear(); }
     void validateSizes() const;
 
     void onLinesVisibilityChanged(const LinesVisibility*);
@@ -138,7 +155,24 @@ private:
     // cache for line sizes
     // m_visibleLinesSizes[line] - start position of the visible line
     // m_visibleLinesSizes[visibleLineCount] - end position of the last visible line
-    mutable QVector<int> m_visibleLinesSizes;
+    // it's empty if visible lines have uniform size (see m_uniformLineSize)
+    mutable QVector<qint64> m_visibleLinesSizes;
+
+    // visible line which size differs from m_uniformLineSize
+    struct SizeException
+    {
+        int visibleLine;
+        int size;
+        // sum of (size - m_uniformLineSize) for all previous exceptions
+        qint64 deltaBefore;
+    };
+
+    mutable bool m_isSizesValid;
+    // size of most visible lines or InvalidIndex if m_visibleLinesSizes is used
+    mutable int m_uniformLineSize;
+    // sorted by visibleLine, only few lines are allowed
+    mutable QVector<SizeException> m_sizeExceptions;
+    mutable qint64 m_visibleSize;
 
     //
     // lines visibility stuff
@@ -15,6 +15,8 @@
 */
 
 #include "Space.h"
+#include "core/Model.h"
+#include "utils/MemoryUsage.h"
 
 namespace Qi
 {
@@ -29,6 +31,48 @@ Space::~Space()
     clearSchemas();
 }
 
+SpacePoint Space::extent() const
+{
+    QSize spaceSize = size();
+    return SpacePoint(spaceSize.width(), spaceSize.height());
+}
+
+SpacePoint Space::itemPosition(const ItemID& visibleItem) const
+{
+    QPoint position = itemRect(visibleItem).topLeft();
+    return SpacePoint(position.x(), position.y());
+}
+
+QRect Space::localItemRect(const ItemID& visibleItem, const SpacePoint& origin) const
+{
+    return itemRect(visibleItem).translated(int(-origin.x), int(-origin.y));
+}
+
+qint64 Space::memoryUsage() const
+{
+    qint64 bytes = sizeof(*this) + containerMemory(m_schemas) + containerMemory(m_schemasOrdered);
+
+    // ranges and models can be shared between schemas
+    QSet<const QObject*> counted;
+    for (const auto& schema: m_schemas)
+    {
+        if (!counted.contains(schema.range.data()))
+        {
+            counted.insert(schema.range.data());
+            bytes += schema.range->memoryUsage();
+        }
+
+        const Model* model = schema.view->model();
+        if (model && !counted.contains(model))
+        {
+            counted.insert(model);
+            bytes += model->memoryUsage();
+        }
+    }
+
+    return bytes;
+}
+
 const QVector<ItemSchema>& Space::schemasOrdered() const
 {
     if (m_schemasOrdered.isEmpty() && !m_schemas.isEmpty())
@@ -149,12 +193,12 @@ void Space::onLayoutChanged(const Layout* /*layout*/, ChangeReason reason)
     emit spaceChanged(this, reason | ChangeReasonSpaceItemsStructure);
 }
 
-void Space::onViewChanged(const View* /*view*/, ChangeReason reason)
+void Space::onViewChanged(const View* /*view*/, ChangeReason reason, const ChangedItems& items)
 {
     if (reason & ChangeReasonViewSize)
-        emit spaceChanged(this, reason | ChangeReasonSpaceItemsStructure);
+        emit spaceChanged(this, reason | ChangeReasonSpaceItemsStructure, items);
     else
-        emit spaceChanged(this, reason | ChangeReasonSpaceItemsContent);
+        emit spaceChanged(this, reason | ChangeReasonSpaceItemsContent, items);
 }
 
 } // end namespace Qi
@@ -28,6 +28,29 @@ namespace Qi
 
 class CacheItemFactory;
 
+// point in 64-bit space coordinates
+// used by spaces which sizes exceed int range
+class QI_EXPORT SpacePoint
+{
+public:
+    qint64 x;
+    qint64 y;
+
+    SpacePoint(qint64 x = 0, qint64 y = 0)
+        : x(x), y(y)
+    {}
+};
+
+inline bool operator==(const SpacePoint& left, const SpacePoint& right)
+{
+    return (left.x == right.x) && (left.y == right.y);
+}
+
+inline bool operator!=(const SpacePoint& left, const SpacePoint& right)
+{
+    return !(left == right);
+}
+
 class QI_EXPORT Space: public QObject
 {
     Q_OBJECT
@@ -43,6 +66,13 @@ public:
     virtual QRect itemRect(const ItemID& visibleItem) const = 0;
     virtual QSharedPointer<CacheItemFactory> createCacheItemFactory(ViewApplicationMask viewApplicationMask = ViewApplicationNone) const = 0;
 
+    // 64-bit versions of size and item geometry
+    // size() and itemRect() are limited by int range
+    virtual SpacePoint extent() const;
+    virtual SpacePoint itemPosition(const ItemID& visibleItem) const;
+    // item rectangle relative to origin point of the space
+    virtual QRect localItemRect(const ItemID& visibleItem, const SpacePoint& origin) const;
+
     const QVector<ItemSchema>& schemas() const { return m_schemas; }
     int addSchema(const ItemSchema& schema);
     int addSchema(const QSharedPointer<Range>& range, const QSharedPointer<View>& view, const QSharedPointer<Layout>& layout = makeLayoutClient()) { return addSchema(ItemSchema(range, layout, view)); }
@@ -55,13 +85,18 @@ public:
 
     const QVector<ItemSchema>& schemasOrdered() const;
 
+    // returns approximate memory used by the schemas, their ranges and models in bytes
+    // lines of the grid spaces are not included as they can be shared
+    virtual qint64 memoryUsage() const;
+
 signals:
-    void spaceChanged(const Space* space, ChangeReason reason);
+    // items - absolute items which have been changed
+    void spaceChanged(const Space* space, ChangeReason reason, const ChangedItems& items = ChangedItems());
 
 private slots:
     void onRangeChanged(const Range* range, ChangeReason reason);
     void onLayoutChanged(const Layout* layout, ChangeReason reason);
-    void onViewChanged(const View* view, ChangeReason reason);
+    void onViewChanged(const View* view, ChangeReason reason, const ChangedItems& items);
 
 private:
     void connectSchema(const ItemSchema& schema);
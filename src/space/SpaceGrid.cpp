@@ -18,6 +18,8 @@
 #include "core/Model.h"
 #include "core/ext/Ranges.h"
 #include "cache/CacheItemFactory.h"
+#include "misc/Trace.h"
+#include <limits>
 
 namespace Qi
 {
@@ -435,19 +437,33 @@ QSize SpaceGrid::dimensions() const
 
 QSize SpaceGrid::size() const
 {
-    return QSize((int)m_columns->visibleSize(), (int)m_rows->visibleSize());
+    // huge grids are clipped, see extent()
+    return QSize((int)qMin<qint64>(m_columns->visibleSize(), std::numeric_limits<int>::max()), (int)qMin<qint64>(m_rows->visibleSize(), std::numeric_limits<int>::max()));
 }
 
 QRect SpaceGrid::itemRect(const ItemID& visibleItem) const
+{
+    return localItemRect(visibleItem, SpacePoint());
+}
+
+SpacePoint SpaceGrid::itemPosition(const ItemID& visibleItem) const
+{
+    Q_ASSERT(visibleItem.isValid());
+    Q_ASSERT(checkVisibleItem(visibleItem));
+
+    return SpacePoint(m_columns->startPos(visibleItem.column), m_rows->startPos(visibleItem.row));
+}
+
+QRect SpaceGrid::localItemRect(const ItemID& visibleItem, const SpacePoint& origin) const
 {
     Q_ASSERT(visibleItem.isValid());
     Q_ASSERT(checkVisibleItem(visibleItem));
 
     QRect rect(0, 0, 0, 0);
-    rect.setTop(m_rows->startPos(visibleItem.row));
-    rect.setLeft(m_columns->startPos(visibleItem.column));
-    rect.setBottom(m_rows->endPos(visibleItem.row));
-    rect.setRight(m_columns->endPos(visibleItem.column));
+    rect.setTop((int)(m_rows->startPos(visibleItem.row) - origin.y));
+    rect.setLeft((int)(m_columns->startPos(visibleItem.column) - origin.x));
+    rect.setBottom((int)(m_rows->endPos(visibleItem.row) - origin.y));
+    rect.setRight((int)(m_columns->endPos(visibleItem.column) - origin.x));
 
     return rect;
 }
@@ -551,6 +567,8 @@ void SpaceGrid::sortColumnByModel(int column, const QSharedPointer<ModelComparab
     if (column >= m_columns->count())
         return;
 
+    TraceScope traceScope("SpaceGrid::sortColumnByModel", "sorting");
+
     if (ascending)
         m_rows->sort(stable, AscendingColumnComparatorByModel(column, model));
     else
@@ -575,6 +593,8 @@ void SpaceGrid::sortColumnByRangedModel(int column, const QSharedPointer<ModelCo
     if (column >= m_columns->count())
         return;
 
+    TraceScope traceScope("SpaceGrid::sortColumnByRangedModel", "sorting");
+
     if (ascending)
         m_rows->sort(stable, AscendingColumnComparatorByRangedModel(column, model, range, outOfRangeIsSmall));
     else
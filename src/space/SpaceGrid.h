@@ -52,6 +52,9 @@ public:
     ItemID toVisible(const ItemID& absoluteItem) const override { return ItemID(m_rows->toVisibleSafe(absoluteItem.row), m_columns->toVisibleSafe(absoluteItem.column)); }
     QRect itemRect(const ItemID& visibleItem) const override;
     QSharedPointer<CacheItemFactory> createCacheItemFactory(ViewApplicationMask viewApplicationMask = ViewApplicationNone) const override;
+    SpacePoint extent() const override { return SpacePoint(m_columns->visibleSize(), m_rows->visibleSize()); }
+    SpacePoint itemPosition(const ItemID& visibleItem) const override;
+    QRect localItemRect(const ItemID& visibleItem, const SpacePoint& origin) const override;
 
     bool isEmpty() const { return m_rows->isEmpty() || m_columns->isEmpty(); }
     bool isEmptyVisible() const { return m_rows->isEmptyVisible() || m_columns->isEmptyVisible(); }
@@ -16,10 +16,160 @@
 
 #include "SpaceScene.h"
 #include "cache/CacheItemFactory.h"
+#include "utils/MemoryUsage.h"
+#include <algorithm>
 
 namespace Qi
 {
 
+static int floorDiv(int value, int divider)
+{
+    return (value >= 0) ? (value / divider) : -((-value + divider - 1) / divider);
+}
+
+// uniform grid of cells over element rects
+// elements covering too many cells are kept in separate list
+class SceneIndex
+{
+    Q_DISABLE_COPY(SceneIndex)
+
+public:
+    explicit SceneIndex(int cellSize)
+        : m_cellSize(cellSize)
+    {
+        Q_ASSERT(m_cellSize > 0);
+    }
+
+    int count() const { return m_rects.size(); }
+    const QVector<QRect>& rects() const { return m_rects; }
+
+    void append(const QRect& rect)
+    {
+        m_rects.append(rect);
+        insert(m_rects.size() - 1);
+    }
+
+    void update(int element, const QRect& rect)
+    {
+        remove(element);
+        m_rects[element] = rect;
+        insert(element);
+    }
+
+    template <typename Predicate>
+    QVector<ItemID> find(const QRect& rect, Predicate isFound) const
+    {
+        QVector<int> elements;
+        auto visit = [this, &elements, &isFound](int element) {
+            if (isFound(m_rects[element]))
+                elements.append(element);
+        };
+
+        for (int element: m_largeElements)
+            visit(element);
+
+        QRect cells = cellsRect(rect);
+        if (qint64(cells.width()) * cells.height() > m_cells.size())
+        {
+            // query is larger than the occupied cells
+            for (auto it = m_cells.begin(); it != m_cells.end(); ++it)
+            {
+                if (cells.contains(cellPoint(it.key())))
+                    std::for_each(it.value().begin(), it.value().end(), visit);
+            }
+        }
+        else
+        {
+            for (int y = cells.top(); y <= cells.bottom(); ++y)
+            {
+                for (int x = cells.left(); x <= cells.right(); ++x)
+                {
+                    auto it = m_cells.find(cellKey(x, y));
+                    if (it != m_cells.end())
+                        std::for_each(it.value().begin(), it.value().end(), visit);
+                }
+            }
+        }
+
+        // elements from several cells are found several times
+        std::sort(elements.begin(), elements.end());
+        elements.erase(std::unique(elements.begin(), elements.end()), elements.end());
+
+        QVector<ItemID> items;
+        items.reserve(elements.size());
+        for (int element: elements)
+            items.append(ItemID(0, element));
+
+        return items;
+    }
+
+    qint64 memoryUsage() const
+    {
+        qint64 bytes = sizeof(*this) + containerMemory(m_rects) + containerMemory(m_cells) + containerMemory(m_largeElements);
+        for (const auto& elements: m_cells)
+            bytes += containerMemory(elements);
+
+        return bytes;
+    }
+
+private:
+    // elements covering more cells are not split between cells
+    static const int MaxElementCells = 16;
+
+    static quint64 cellKey(int x, int y) { return (quint64(quint32(x)) << 32) | quint32(y); }
+    static QPoint cellPoint(quint64 key) { return QPoint(int(quint32(key >> 32)), int(quint32(key))); }
+
+    QRect cellsRect(const QRect& rect) const
+    {
+        QRect normalized = rect.normalized();
+        return QRect(QPoint(floorDiv(normalized.left(), m_cellSize), floorDiv(normalized.top(), m_cellSize)),
+                     QPoint(floorDiv(normalized.right(), m_cellSize), floorDiv(normalized.bottom(), m_cellSize)));
+    }
+
+    void insert(int element)
+    {
+        QRect cells = cellsRect(m_rects[element]);
+        if (qint64(cells.width()) * cells.height() > MaxElementCells)
+        {
+            m_largeElements.append(element);
+            return;
+        }
+
+        for (int y = cells.top(); y <= cells.bottom(); ++y)
+        {
+            for (int x = cells.left(); x <= cells.right(); ++x)
+                m_cells[cellKey(x, y)].append(element);
+        }
+    }
+
+    void remove(int element)
+    {
+        QRect cells = cellsRect(m_rects[element]);
+        if (qint64(cells.width()) * cells.height() > MaxElementCells)
+        {
+            m_largeElements.removeOne(element);
+            return;
+        }
+
+        for (int y = cells.top(); y <= cells.bottom(); ++y)
+        {
+            for (int x = cells.left(); x <= cells.right(); ++x)
+            {
+                auto it = m_cells.find(cellKey(x, y));
+                Q_ASSERT(it != m_cells.end());
+                it.value().removeOne(element);
+                if (it.value().isEmpty())
+                    m_cells.erase(it);
+            }
+        }
+    }
+
+    int m_cellSize;
+    QVector<QRect> m_rects;
+    QHash<quint64, QVector<int>> m_cells;
+    QVector<int> m_largeElements;
+};
+
 class RangeByType: public Range
 {
 public:
@@ -100,11 +250,12 @@ QSize SpaceScene::size() const
     if (m_sizeIsValid)
         return m_size;
 
+    // index keeps element rects
+    validateIndex();
+
     m_size = QSize(0, 0);
-    int count = countImpl();
-    for (ItemID item(0, 0); item.column < count; ++item.column)
+    for (const auto& rect: m_index->rects())
     {
-        QRect rect = itemRect(item);
         m_size.rwidth() = qMax(m_size.width(), rect.right());
         m_size.rheight() = qMax(m_size.height(), rect.bottom());
     }
@@ -113,6 +264,23 @@ QSize SpaceScene::size() const
     return m_size;
 }
 
+QVector<ItemID> SpaceScene::itemsInRect(const QRect& rect) const
+{
+    validateIndex();
+    return m_index->find(rect, [&rect](const QRect& elementRect) { return rect.intersects(elementRect); });
+}
+
+QVector<ItemID> SpaceScene::itemsAtPoint(const QPoint& point) const
+{
+    validateIndex();
+    return m_index->find(QRect(point, QSize(1, 1)), [&point](const QRect& elementRect) { return elementRect.contains(point); });
+}
+
+qint64 SpaceScene::memoryUsage() const
+{
+    return Space::memoryUsage() + (m_index ? m_index->memoryUsage() : 0);
+}
+
 QSharedPointer<CacheItemFactory> SpaceScene::createCacheItemFactory(ViewApplicationMask viewApplicationMask) const
 {
     switch (m_hint) {
@@ -126,9 +294,74 @@ QSharedPointer<CacheItemFactory> SpaceScene::createCacheItemFactory(ViewApplicat
 void SpaceScene::notifyCountChanged()
 {
     m_sizeIsValid = false;
+    m_index.reset();
+    emit spaceChanged(this, ChangeReasonSpaceHint);
+}
+
+void SpaceScene::notifyElementsAppended(int first)
+{
+    if (m_index)
+    {
+        int count = countImpl();
+        Q_ASSERT(first == m_index->count());
+        Q_ASSERT(first <= count);
+
+        for (ItemID item(0, first); item.column < count; ++item.column)
+        {
+            QRect rect = itemRect(item);
+            m_index->append(rect);
+
+            if (m_sizeIsValid)
+            {
+                m_size.rwidth() = qMax(m_size.width(), rect.right());
+                m_size.rheight() = qMax(m_size.height(), rect.bottom());
+            }
+        }
+    }
+    else
+    {
+        m_sizeIsValid = false;
+    }
+
     emit spaceChanged(this, ChangeReasonSpaceHint);
 }
 
+void SpaceScene::notifyElementMoved(const ItemID& item)
+{
+    Q_ASSERT(item.column >= 0 && item.column < countImpl());
+
+    if (m_index)
+        m_index->update(item.column, itemRect(item));
+
+    // cached items should be placed again
+    m_sizeIsValid = false;
+    emit spaceChanged(this, ChangeReasonSpaceStructure);
+}
+
+void SpaceScene::validateIndex() const
+{
+    if (m_index)
+        return;
+
+    int count = countImpl();
+    QVector<QRect> rects;
+    rects.reserve(count);
+
+    qint64 extents = 0;
+    for (ItemID item(0, 0); item.column < count; ++item.column)
+    {
+        rects.append(itemRect(item));
+        extents += qMax(qAbs(rects.back().width()), qAbs(rects.back().height()));
+    }
+
+    // cells about twice of the average element keep few elements per cell
+    int cellSize = count ? int(qBound(qint64(32), 2 * extents / count, qint64(4096))) : 256;
+
+    m_index.reset(new SceneIndex(cellSize));
+    for (const auto& rect: rects)
+        m_index->append(rect);
+}
+
 SpaceSceneElements::SpaceSceneElements(SpaceSceneHint hint)
     : SpaceScene(hint)
 {
@@ -141,7 +374,7 @@ SpaceSceneElements::~SpaceSceneElements()
 void SpaceSceneElements::addElement(const QSharedPointer<SceneElement>& element)
 {
     m_elements.append(element);
-    notifyCountChanged();
+    notifyElementsAppended(m_elements.size() - 1);
 }
 
 void SpaceSceneElements::clearElements()
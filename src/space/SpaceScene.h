@@ -22,6 +22,8 @@
 namespace Qi
 {
 
+class SceneIndex;
+
 enum SpaceSceneHint
 {
     SpaceSceneHintNone = 0x0000,
@@ -50,17 +52,33 @@ public:
 
     int itemType(const ItemID &visibleItem) const { return elementTypeImpl(visibleItem); }
 
+    // items in ascending order found by the spatial index
+    QVector<ItemID> itemsInRect(const QRect& rect) const;
+    QVector<ItemID> itemsAtPoint(const QPoint& point) const;
+
+    qint64 memoryUsage() const override;
+
+    // element rects are indexed, should be called after the rect of the element has been changed
+    // elements placed by it (anchors, connections) should be notified as well
+    void notifyElementMoved(const ItemID& item);
+
 protected:
     virtual int countImpl() const = 0;
     virtual QRect elementRectImpl(const ItemID& item) const = 0;
     virtual int elementTypeImpl(const ItemID& item) const = 0;
 
+    // rebuilds spatial index on demand
     void notifyCountChanged();
+    // updates spatial index with elements appended from first one
+    void notifyElementsAppended(int first);
 
 private:
+    void validateIndex() const;
+
     SpaceSceneHint m_hint;
     mutable bool m_sizeIsValid;
     mutable QSize m_size;
+    mutable QScopedPointer<SceneIndex> m_index;
 };
 
 QI_EXPORT QSharedPointer<Range> makeRangeByType(const SpaceScene* scene, int type);
@@ -106,6 +124,7 @@ class QI_EXPORT SceneElement
 public:
     virtual ~SceneElement() {}
 
+    // rect may change only with SpaceScene::notifyElementMoved call
     QRect rect() const { return rectImpl(); }
     int type() const { return typeImpl(); }
 
@@ -0,0 +1,54 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef QI_MEMORY_USAGE_H
+#define QI_MEMORY_USAGE_H
+
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QVector>
+
+namespace Qi
+{
+
+// approximate heap memory occupied by container nodes (in bytes)
+// memory owned by the values themselves is not included
+
+template <typename T> qint64 containerMemory(const QVector<T>& values)
+{
+    return qint64(values.capacity()) * sizeof(T);
+}
+
+template <typename K, typename V> qint64 containerMemory(const QHash<K, V>& values)
+{
+    // buckets array plus node per value
+    return qint64(values.capacity()) * sizeof(void*) + qint64(values.size()) * (sizeof(K) + sizeof(V) + 2 * sizeof(void*));
+}
+
+template <typename T> qint64 containerMemory(const QSet<T>& values)
+{
+    return qint64(values.capacity()) * sizeof(void*) + qint64(values.size()) * (sizeof(T) + 2 * sizeof(void*));
+}
+
+template <typename K, typename V> qint64 containerMemory(const QMap<K, V>& values)
+{
+    // red-black tree node per value
+    return qint64(values.size()) * (sizeof(K) + sizeof(V) + 3 * sizeof(void*));
+}
+
+} // end namespace Qi
+
+#endif // QI_MEMORY_USAGE_H
@@ -0,0 +1,132 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef QI_RING_BUFFER_MPSC_H
+#define QI_RING_BUFFER_MPSC_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace Qi
+{
+
+// bounded lock-free queue for many producers and a single consumer
+// capacity is rounded up to the power of two
+template <typename T>
+class RingBufferMPSC
+{
+    Q_DISABLE_COPY(RingBufferMPSC)
+
+public:
+    explicit RingBufferMPSC(int capacity)
+        : m_enqueuePos(0),
+          m_dequeuePos(0)
+    {
+        Q_ASSERT(capacity > 0);
+
+        size_t size = 2;
+        while (size < size_t(capacity))
+            size <<= 1;
+
+        m_cells.reset(new Cell[size]);
+        m_mask = size - 1;
+
+        for (size_t i = 0; i < size; ++i)
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    int capacity() const { return int(m_mask + 1); }
+
+    // can be called from any thread
+    // returns false if queue is full
+    bool push(const T& value)
+    {
+        Cell* cell = nullptr;
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            cell = &m_cells[pos & m_mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = intptr_t(sequence) - intptr_t(pos);
+
+            if (diff == 0)
+            {
+                // try to reserve the cell
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                // consumer hasn't freed the cell yet
+                return false;
+            }
+            else
+            {
+                // other producer has taken the cell
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = value;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // should be called from the consumer thread only
+    // returns false if queue is empty
+    bool pop(T& value)
+    {
+        Cell* cell = &m_cells[m_dequeuePos & m_mask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+
+        // producer hasn't published the cell yet
+        if (intptr_t(sequence) - intptr_t(m_dequeuePos + 1) < 0)
+            return false;
+
+        value = std::move(cell->value);
+        cell->sequence.store(m_dequeuePos + m_mask + 1, std::memory_order_release);
+        ++m_dequeuePos;
+
+        return true;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    // padding instead of alignas keeps heap allocation not over-aligned
+    static const size_t CacheLineSize = 64;
+
+    std::unique_ptr<Cell[]> m_cells;
+    size_t m_mask;
+
+    // keep producers and consumer positions on different cache lines
+    char m_enqueuePadding[CacheLineSize];
+    std::atomic<size_t> m_enqueuePos;
+    char m_dequeuePadding[CacheLineSize - sizeof(std::atomic<size_t>)];
+    size_t m_dequeuePos;
+};
+
+} // end namespace Qi
+
+#endif // QI_RING_BUFFER_MPSC_H
@@ -0,0 +1,95 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef QI_VECTOR_EDIT_H
+#define QI_VECTOR_EDIT_H
+
+#include <QVector>
+#include <utility>
+
+namespace Qi
+{
+
+// removes values at ascending unique indices in one pass
+// if blockSize > 0 values are split into blocks of blockSize
+// and indices are removed from every block (rows of column-major grid)
+template <typename T> void removeValues(QVector<T>& values, const QVector<int>& indices, int blockSize = 0)
+{
+    if (indices.isEmpty() || values.isEmpty())
+        return;
+
+    if (blockSize <= 0)
+        blockSize = values.size();
+
+    Q_ASSERT(values.size() % blockSize == 0);
+    Q_ASSERT(indices.back() < blockSize);
+
+    int write = 0;
+    for (int base = 0; base < values.size(); base += blockSize)
+    {
+        int next = 0;
+        for (int i = 0; i < blockSize; ++i)
+        {
+            if (next < indices.size() && indices[next] == i)
+            {
+                ++next;
+                continue;
+            }
+
+            if (write != base + i)
+                values[write] = std::move(values[base + i]);
+            ++write;
+        }
+    }
+
+    values.resize(write);
+}
+
+// inserts count values before index
+// if blockSize > 0 values are inserted into every block of blockSize
+template <typename T> void insertValues(QVector<T>& values, int before, int count, const T& value = T(), int blockSize = 0)
+{
+    Q_ASSERT(count >= 0);
+    if (count == 0)
+        return;
+
+    if (blockSize <= 0)
+    {
+        values.insert(before, count, value);
+        return;
+    }
+
+    Q_ASSERT(values.size() % blockSize == 0);
+    Q_ASSERT(before <= blockSize);
+
+    QVector<T> newValues;
+    newValues.reserve(values.size() + (values.size() / blockSize) * count);
+    for (int base = 0; base < values.size(); base += blockSize)
+    {
+        for (int i = 0; i < before; ++i)
+            newValues.append(std::move(values[base + i]));
+        for (int i = 0; i < count; ++i)
+            newValues.append(value);
+        for (int i = before; i < blockSize; ++i)
+            newValues.append(std::move(values[base + i]));
+    }
+
+    values.swap(newValues);
+}
+
+} // end namespace Qi
+
+#endif // QI_VECTOR_EDIT_H
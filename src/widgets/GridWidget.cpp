@@ -20,7 +20,6 @@
 #include "items/cache/ViewCacheSpace.h"
 #include "core/ext/Ranges.h"
 #include "core/ext/Layouts.h"
-#include <QScrollBar>
 
 namespace Qi
 {
@@ -49,6 +48,11 @@ GridWidget::GridWidget(QWidget* parent)
             SpaceGridHint hint = (subID.row == 1) ? SpaceGridHintSameSchemasByColumn : SpaceGridHintNone;
             auto subGrid = QSharedPointer<SpaceGrid>::create(m_rows[subID.row], m_columns[subID.column], hint);
             auto cacheSpace = QSharedPointer<CacheSpaceGrid>::create(subGrid);
+            // prepare scrollable lines in advance
+            cacheSpace->setPrefetchMargin((subID.row == 1) ? 8 : 0, (subID.column == 1) ? 2 : 0);
+            // keep scrolled away items for scrolling back
+            if (subID == clientID)
+                cacheSpace->setRetainBudget(1024);
 
             m_cacheSubGrids[subID.row][subID.column] = cacheSpace;
             modelCache->setValue(subID, cacheSpace);
@@ -95,30 +99,31 @@ void GridWidget::ensureVisibleImpl(const ItemID& visibleItem, const CacheSpace *
     if (clientGridRect.isEmpty())
         return;
 
-    QPoint scrollPos(horizontalScrollBar()->value(), verticalScrollBar()->value());
-    QRect itemRect = cacheSpace->space().itemRect(visibleItem);
+    SpacePoint scrollPos = scrollPosition();
+    SpacePoint itemPos = cacheSpace->space().itemPosition(visibleItem);
+    // item rectangle relative to item position
+    QRect itemRect = cacheSpace->space().localItemRect(visibleItem, itemPos);
 
     // if client columns -> correct scroll position horizontally
     if (cacheSpaceGrid->spaceGrid()->columns() ==  m_columns[1])
     {
-        if ((itemRect.width() >= clientGridRect.width()) || (itemRect.left() < scrollPos.x()))
-            scrollPos.rx() = itemRect.left();
-        else if (itemRect.right() > (scrollPos.x() + clientGridRect.width()))
-            scrollPos.rx() = itemRect.right() - clientGridRect.width();
+        if ((itemRect.width() >= clientGridRect.width()) || (itemPos.x < scrollPos.x))
+            scrollPos.x = itemPos.x;
+        else if (itemPos.x + itemRect.right() > (scrollPos.x + clientGridRect.width()))
+            scrollPos.x = itemPos.x + itemRect.right() - clientGridRect.width();
     }
 
     // if client rows -> correct scroll position vertically
     if (cacheSpaceGrid->spaceGrid()->rows() ==  m_rows[1])
     {
-        if ((itemRect.height() >= clientGridRect.height()) || (itemRect.top() < scrollPos.y()))
-            scrollPos.ry() = itemRect.top();
-        else if (itemRect.bottom() > (scrollPos.y() + clientGridRect.height()))
-            scrollPos.ry() = itemRect.bottom() - clientGridRect.height();
+        if ((itemRect.height() >= clientGridRect.height()) || (itemPos.y < scrollPos.y))
+            scrollPos.y = itemPos.y;
+        else if (itemPos.y + itemRect.bottom() > (scrollPos.y + clientGridRect.height()))
+            scrollPos.y = itemPos.y + itemRect.bottom() - clientGridRect.height();
     }
 
     // scroll to new position
-    horizontalScrollBar()->setValue(scrollPos.x());
-    verticalScrollBar()->setValue(scrollPos.y());
+    setScrollPosition(scrollPos);
 
     if (validateItem)
     {
@@ -150,10 +155,30 @@ void GridWidget::onSubGridChanged(const Space* /*space*/, ChangeReason reason)
     }
 }
 
-void GridWidget::onCacheSpaceChanged(const CacheSpace* /*cache*/, ChangeReason /*reason*/)
+void GridWidget::onCacheSpaceChanged(const CacheSpace* /*cache*/, ChangeReason reason, const QRegion& windowRegion)
 {
-    // repaint widget
-    viewport()->update();
+    // sub-grid windows are in viewport coordinates
+    scheduleRepaint(windowRegion, reason);
+}
+
+qint64 GridWidget::memoryUsageImpl() const
+{
+    qint64 bytes = SpaceWidgetScrollAbstract::memoryUsageImpl();
+
+    // sub rows and columns are shared between sub grids
+    for (int i = 0; i < 3; ++i)
+        bytes += m_rows[i]->memoryUsage() + m_columns[i]->memoryUsage();
+
+    for (ItemID subID = ItemID(0, 0); subID.row < 3; ++subID.row)
+    {
+        for (subID.column = 0; subID.column < 3; ++subID.column)
+        {
+            const auto& cacheSubGrid = m_cacheSubGrids[subID.row][subID.column];
+            bytes += cacheSubGrid->memoryUsage() + cacheSubGrid->space().memoryUsage();
+        }
+    }
+
+    return bytes;
 }
 
 QSize GridWidget::calculateVirtualSizeImpl() const
@@ -161,6 +186,11 @@ QSize GridWidget::calculateVirtualSizeImpl() const
     return subGrid(clientID)->size();
 }
 
+SpacePoint GridWidget::calculateVirtualExtentImpl() const
+{
+    return subGrid(clientID)->extent();
+}
+
 QSize GridWidget::calculateScrollableSizeImpl() const
 {
     return viewport()->size() - subGrid(topLeftID)->size() - subGrid(bottomRightID)->size();
@@ -169,27 +199,27 @@ QSize GridWidget::calculateScrollableSizeImpl() const
 void GridWidget::updateCacheScrollOffsetImpl()
 {
     // get scroll positions
-    QPoint scrollPos(horizontalScrollBar()->value(), verticalScrollBar()->value());
+    SpacePoint scrollPos = scrollPosition();
 
     // non scrollable sub-grids (corner sub-grids)
-    QPoint fixedScrollPos(0, 0);
-    cacheSubGrid(topLeftID)->setScrollOffset(fixedScrollPos);
-    cacheSubGrid(topRightID)->setScrollOffset(fixedScrollPos);
-    cacheSubGrid(bottomLeftID)->setScrollOffset(fixedScrollPos);
-    cacheSubGrid(bottomRightID)->setScrollOffset(fixedScrollPos);
+    SpacePoint fixedScrollPos(0, 0);
+    cacheSubGrid(topLeftID)->setScrollPosition(fixedScrollPos);
+    cacheSubGrid(topRightID)->setScrollPosition(fixedScrollPos);
+    cacheSubGrid(bottomLeftID)->setScrollPosition(fixedScrollPos);
+    cacheSubGrid(bottomRightID)->setScrollPosition(fixedScrollPos);
 
     // horizontally scrollable sub-grids (top and bottom)
-    QPoint horScrollPos(scrollPos.x(), 0);
-    cacheSubGrid(topID)->setScrollOffset(horScrollPos);
-    cacheSubGrid(bottomID)->setScrollOffset(horScrollPos);
+    SpacePoint horScrollPos(scrollPos.x, 0);
+    cacheSubGrid(topID)->setScrollPosition(horScrollPos);
+    cacheSubGrid(bottomID)->setScrollPosition(horScrollPos);
 
     // vertically scrollable sub-grids (left and right)
-    QPoint verScrollPos(0, scrollPos.y());
-    cacheSubGrid(leftID)->setScrollOffset(verScrollPos);
-    cacheSubGrid(rightID)->setScrollOffset(verScrollPos);
+    SpacePoint verScrollPos(0, scrollPos.y);
+    cacheSubGrid(leftID)->setScrollPosition(verScrollPos);
+    cacheSubGrid(rightID)->setScrollPosition(verScrollPos);
 
     // fully scrollable sub-grid - client
-    cacheSubGrid(clientID)->setScrollOffset(scrollPos);
+    cacheSubGrid(clientID)->setScrollPosition(scrollPos);
 }
 
 void GridWidget::validateCacheItemsLayoutImpl()
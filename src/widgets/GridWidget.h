@@ -66,16 +66,18 @@ protected:
 
     // SpaceWidgetCore implementation
     void ensureVisibleImpl(const ItemID& visibleItem, const CacheSpace *cacheSpace, bool validateItem) override;
+    qint64 memoryUsageImpl() const override;
 
     // SpaceWidgetScrollAbstract implementation
     void validateCacheItemsLayoutImpl() override;
     QSize calculateVirtualSizeImpl() const override;
+    SpacePoint calculateVirtualExtentImpl() const override;
     QSize calculateScrollableSizeImpl() const override;
     void updateCacheScrollOffsetImpl() override;
 
 private:
     void onSubGridChanged(const Space* space, ChangeReason reason);
-    void onCacheSpaceChanged(const CacheSpace* cache, ChangeReason reason);
+    void onCacheSpaceChanged(const CacheSpace* cache, ChangeReason reason, const QRegion& windowRegion);
 
     QSharedPointer<SpaceGrid> m_mainGrid;
 
@@ -51,11 +51,20 @@ ListWidget::~ListWidget()
 {
 }
 
-void ListWidget::onCacheSpaceGridChanged(const CacheSpace* cache, ChangeReason /*reason*/)
+qint64 ListWidget::memoryUsageImpl() const
+{
+    return SpaceWidgetScrollAbstract::memoryUsageImpl() +
+           m_grid->rows()->memoryUsage() +
+           m_grid->columns()->memoryUsage() +
+           m_grid->memoryUsage() +
+           m_cacheGrid->memoryUsage();
+}
+
+void ListWidget::onCacheSpaceGridChanged(const CacheSpace* cache, ChangeReason reason, const QRegion& windowRegion)
 {
     Q_UNUSED(cache);
     Q_ASSERT(cache == m_cacheGrid.data());
-    viewport()->update();;
+    scheduleRepaint(windowRegion, reason);
 }
 
 void ListWidget::onSpaceGridChanged(const Space* space, ChangeReason reason)
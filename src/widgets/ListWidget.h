@@ -49,9 +49,10 @@ public:
 
 protected:
     QPixmap createPixmapImpl() const;
+    qint64 memoryUsageImpl() const override;
 
 private:
-    void onCacheSpaceGridChanged(const CacheSpace* cache, ChangeReason reason);
+    void onCacheSpaceGridChanged(const CacheSpace* cache, ChangeReason reason, const QRegion& windowRegion);
     void onSpaceGridChanged(const Space* space, ChangeReason reason);
 
     QSharedPointer<SpaceGrid> m_grid;
@@ -19,19 +19,63 @@
 #include "cache/CacheControllerMouse.h"
 #include "core/ControllerKeyboard.h"
 #include "utils/PainterState.h"
+#include "utils/auto_value.h"
+#include "misc/RenderStats.h"
+#include "misc/Trace.h"
 
 #include <QWidget>
 #include <QToolTip>
+#include <QTimer>
+#include <QMouseEvent>
 
 namespace Qi
 {
 
+static bool isInputEvent(QEvent::Type type)
+{
+    switch (type)
+    {
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseButtonRelease:
+    case QEvent::MouseButtonDblClick:
+    case QEvent::MouseMove:
+    case QEvent::Wheel:
+    case QEvent::Enter:
+    case QEvent::Leave:
+    case QEvent::KeyPress:
+    case QEvent::KeyRelease:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
 SpaceWidgetCore::SpaceWidgetCore(QWidget* owner)
     : m_owner(owner),
-      m_guiContext(owner)
+      m_guiContext(owner),
+      m_repaintTargetFps(60),
+      m_repaintFrameBudget(8),
+      m_repaintTimer(new QTimer()),
+      m_lastPaintDuration(0),
+      m_isProcessingInput(false),
+      m_isEventCompressionEnabled(false),
+      m_inputTimer(new QTimer()),
+      m_isRenderStatsOverlayVisible(false)
 {
     Q_ASSERT(m_owner);
 
+    m_repaintTimer->setSingleShot(true);
+    QObject::connect(m_repaintTimer.data(), &QTimer::timeout, [this]() {
+        flushRepaint();
+    });
+
+    m_inputTimer->setSingleShot(true);
+    QObject::connect(m_inputTimer.data(), &QTimer::timeout, [this]() {
+        m_inputClock.start();
+        flushPendingInput();
+    });
+
 #if !defined(QT_NO_DEBUG)
     m_trackOwner = m_owner;
 #endif
@@ -70,8 +114,8 @@ bool SpaceWidgetCore::initSpaceWidgetCore(const QSharedPointer<CacheSpace>& main
     m_mainCacheSpace = mainCacheSpace;
     m_cacheControllers.reset(new CacheControllerMouse(m_owner, this, m_mainCacheSpace));
 
-    m_connection = QObject::connect(m_mainCacheSpace.data(), &CacheSpace::cacheChanged, [this](const CacheSpace* cache, ChangeReason reason) {
-        onCacheSpaceChanged(cache, reason);
+    m_connection = QObject::connect(m_mainCacheSpace.data(), &CacheSpace::cacheChanged, [this](const CacheSpace* cache, ChangeReason reason, const QRegion& windowRegion) {
+        onCacheSpaceChanged(cache, reason, windowRegion);
     });
 
     // enable tracking mouse moves
@@ -98,6 +142,38 @@ void SpaceWidgetCore::addControllerKeyboard(const QSharedPointer<ControllerKeybo
     }
 }
 
+void SpaceWidgetCore::setRepaintTargetFps(int fps)
+{
+    Q_ASSERT(fps >= 0);
+    m_repaintTargetFps = fps;
+}
+
+void SpaceWidgetCore::setRepaintFrameBudget(int msec)
+{
+    Q_ASSERT(msec >= 0);
+    m_repaintFrameBudget = msec;
+}
+
+void SpaceWidgetCore::setEventCompressionEnabled(bool enabled)
+{
+    if (m_isEventCompressionEnabled == enabled)
+        return;
+
+    m_isEventCompressionEnabled = enabled;
+
+    if (!m_isEventCompressionEnabled)
+        flushPendingInput();
+}
+
+void SpaceWidgetCore::setRenderStatsOverlayVisible(bool visible)
+{
+    if (m_isRenderStatsOverlayVisible == visible)
+        return;
+
+    m_isRenderStatsOverlayVisible = visible;
+    m_owner->update();
+}
+
 void SpaceWidgetCore::ensureVisible(const ItemID& visibleItem, const CacheSpace* cacheSpace, bool validateItem)
 {
     ensureVisibleImpl(visibleItem, cacheSpace, validateItem);
@@ -109,6 +185,21 @@ bool SpaceWidgetCore::processOwnerEvent(QEvent* event)
     if (!m_mainCacheSpace)
         return false;
 
+    if (event->type() == QEvent::MouseMove)
+    {
+        // only the latest position is processed per frame
+        m_pendingMouseMove.reset(new QMouseEvent(*static_cast<QMouseEvent*>(event)));
+        // the move is consumed if controllers process it now or on the next frame
+        return schedulePendingInput();
+    }
+
+    // coalesced input goes before other input events
+    if (isInputEvent(event->type()) && (event->type() != QEvent::Wheel))
+        flushPendingInput();
+
+    // changes caused by user input have priority
+    auto_value<bool> processingInput(m_isProcessingInput, m_isProcessingInput || isInputEvent(event->type()));
+
     bool processed = true;
 
     switch (event->type())
@@ -122,11 +213,29 @@ bool SpaceWidgetCore::processOwnerEvent(QEvent* event)
 
     case QEvent::Paint:
     {
+        TraceScope traceScope("SpaceWidgetCore::paint", "paint");
+
         QPainter painter(m_owner);
         painter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing | QPainter::HighQualityAntialiasing);
         painter.setBackgroundMode(Qt::TransparentMode);
+
+        QElapsedTimer paintTimer;
+        paintTimer.start();
+
         // draw cache
         m_mainCacheSpace->draw(&painter, GuiContext(m_owner));
+
+        m_lastPaintDuration = paintTimer.elapsed();
+        m_repaintClock.start();
+
+        RenderStats::endFrame();
+        if (m_isRenderStatsOverlayVisible && RenderStats::isEnabled())
+            drawRenderStatsOverlay(&painter);
+
+        // painted area doesn't need scheduled repaint
+        m_repaintRegion -= static_cast<QPaintEvent*>(event)->region();
+        if (m_repaintRegion.isEmpty())
+            m_repaintTimer->stop();
     } break;
 
     case QEvent::ToolTip:
@@ -201,12 +310,124 @@ void SpaceWidgetCore::resumeControllers()
         m_cacheControllers->resume();
 }
 
-void SpaceWidgetCore::onCacheSpaceChanged(const CacheSpace* cache, ChangeReason /*reason*/)
+void SpaceWidgetCore::scheduleRepaint(const QRegion& region, ChangeReason reason)
+{
+    if (region.isEmpty())
+        return;
+
+    m_repaintRegion += region;
+
+    // scrolling, resizing and user input repaint immediately with pending changes
+    if (m_repaintTargetFps == 0 || m_isProcessingInput || (reason & ChangeReasonCacheFrame))
+    {
+        flushRepaint();
+        return;
+    }
+
+    // data driven changes wait for the next frame
+    if (m_repaintTimer->isActive())
+        return;
+
+    qint64 interval = repaintInterval();
+    qint64 elapsed = m_repaintClock.isValid() ? m_repaintClock.elapsed() : interval;
+    m_repaintTimer->start(int(qMax<qint64>(0, interval - elapsed)));
+}
+
+bool SpaceWidgetCore::schedulePendingInput()
+{
+    if (!m_isEventCompressionEnabled || m_repaintTargetFps == 0)
+        return flushPendingInput();
+
+    // input is already waiting for the next frame
+    if (m_inputTimer->isActive())
+        return true;
+
+    qint64 interval = repaintInterval();
+    qint64 elapsed = m_inputClock.isValid() ? m_inputClock.elapsed() : interval;
+    if (elapsed >= interval)
+    {
+        // first input in the frame is processed immediately
+        m_inputClock.start();
+        return flushPendingInput();
+    }
+
+    m_inputTimer->start(int(interval - elapsed));
+    return true;
+}
+
+bool SpaceWidgetCore::flushPendingInput()
+{
+    m_inputTimer->stop();
+
+    TraceScope traceScope("SpaceWidgetCore::flushPendingInput", "input");
+
+    // changes caused by user input have priority
+    auto_value<bool> processingInput(m_isProcessingInput, true);
+
+    bool processed = false;
+    if (m_pendingMouseMove)
+    {
+        QScopedPointer<QMouseEvent> mouseMove;
+        mouseMove.swap(m_pendingMouseMove);
+        processed = m_cacheControllers->processEvent(mouseMove.data());
+    }
+
+    processPendingInputImpl();
+
+    return processed;
+}
+
+void SpaceWidgetCore::processPendingInputImpl()
+{
+}
+
+void SpaceWidgetCore::flushRepaint()
+{
+    m_repaintTimer->stop();
+
+    if (m_repaintRegion.isEmpty())
+        return;
+
+    m_owner->update(m_repaintRegion);
+    m_repaintRegion = QRegion();
+}
+
+int SpaceWidgetCore::repaintInterval() const
+{
+    Q_ASSERT(m_repaintTargetFps > 0);
+    int frameInterval = 1000 / m_repaintTargetFps;
+
+    if (m_repaintFrameBudget == 0 || m_lastPaintDuration <= m_repaintFrameBudget)
+        return frameInterval;
+
+    // keep painting within the budget share of each frame
+    return int(qMax<qint64>(frameInterval, m_lastPaintDuration * frameInterval / m_repaintFrameBudget));
+}
+
+void SpaceWidgetCore::onCacheSpaceChanged(const CacheSpace* cache, ChangeReason reason, const QRegion& windowRegion)
 {
     Q_UNUSED(cache);
     Q_ASSERT(m_mainCacheSpace.data() == cache);
-    // repaint owner widget
-    m_owner->update();
+    // repaint affected area of owner widget
+    scheduleRepaint(windowRegion, reason);
+}
+
+void SpaceWidgetCore::drawRenderStatsOverlay(QPainter* painter) const
+{
+    QString text = RenderStats::lastFrame().toString();
+    QRect textRect = painter->boundingRect(m_owner->rect(), Qt::AlignLeft | Qt::AlignTop, text).adjusted(-4, -4, 4, 4);
+    textRect.moveTopLeft(QPoint(0, 0));
+
+    painter->save();
+    painter->fillRect(textRect, QColor(0, 0, 0, 160));
+    painter->setPen(Qt::white);
+    painter->drawText(textRect.adjusted(4, 4, -4, -4), Qt::AlignLeft | Qt::AlignTop, text);
+    painter->restore();
+}
+
+qint64 SpaceWidgetCore::memoryUsageImpl() const
+{
+    return m_mainCacheSpace->memoryUsage() + mainSpace().memoryUsage();
 }
 
 QPixmap SpaceWidgetCore::createPixmapImpl() const
@@ -21,9 +21,14 @@
 
 #include <QSharedPointer>
 #include <QMetaObject>
+#include <QElapsedTimer>
+#include <QRegion>
 
 class QWidget;
 class QKeyEvent;
+class QMouseEvent;
+class QTimer;
+class QPainter;
 
 namespace Qi
 {
@@ -59,6 +64,29 @@ public:
 
     QPixmap createPixmap() const { return createPixmapImpl(); }
 
+    // returns approximate memory used by spaces, lines, models and caches of the widget in bytes
+    qint64 memoryUsage() const { return memoryUsageImpl(); }
+
+    // maximum number of data driven repaints per second
+    // 0 - repaint on every change
+    int repaintTargetFps() const { return m_repaintTargetFps; }
+    void setRepaintTargetFps(int fps);
+    // paint time per frame in milliseconds
+    // slower paints stretch interval between data driven repaints
+    int repaintFrameBudget() const { return m_repaintFrameBudget; }
+    void setRepaintFrameBudget(int msec);
+
+    // coalesces mouse moves and wheel scrolls to one per repaint frame
+    // button and key events are delivered in order after pending ones
+    // disabled by default, controllers see every mouse move
+    bool isEventCompressionEnabled() const { return m_isEventCompressionEnabled; }
+    void setEventCompressionEnabled(bool enabled);
+
+    // draws RenderStats of the last frame over the widget
+    // RenderStats should be enabled separately
+    bool isRenderStatsOverlayVisible() const { return m_isRenderStatsOverlayVisible; }
+    void setRenderStatsOverlayVisible(bool visible);
+
 protected:
     explicit SpaceWidgetCore(QWidget* owner);
     ~SpaceWidgetCore();
@@ -74,9 +102,26 @@ protected:
     virtual void ensureVisibleImpl(const ItemID& visibleItem, const CacheSpace *cacheSpace, bool validateItem) = 0;
     // creates image of the widget
     virtual QPixmap createPixmapImpl() const;
+    // returns memory used by the widget
+    virtual qint64 memoryUsageImpl() const;
+
+    // accumulates owner area to repaint on the next frame
+    // input driven changes are repainted immediately
+    void scheduleRepaint(const QRegion& region, ChangeReason reason);
+
+    // processes coalesced input on the next frame
+    // returns true if input is deferred or mouse move is processed by controllers
+    bool schedulePendingInput();
+    // returns true if mouse move is processed by controllers
+    bool flushPendingInput();
+    // processes widget specific coalesced input
+    virtual void processPendingInputImpl();
 
 private:
-    void onCacheSpaceChanged(const CacheSpace* cache, ChangeReason reason);
+    void onCacheSpaceChanged(const CacheSpace* cache, ChangeReason reason, const QRegion& windowRegion);
+    void flushRepaint();
+    int repaintInterval() const;
+    void drawRenderStatsOverlay(QPainter* painter) const;
 
     QWidget* m_owner;
 
@@ -88,6 +133,25 @@ private:
 
     QMetaObject::Connection m_connection;
 
+    // repaint scheduling
+    int m_repaintTargetFps;
+    int m_repaintFrameBudget;
+    QRegion m_repaintRegion;
+    QScopedPointer<QTimer> m_repaintTimer;
+    // time since the last paint
+    QElapsedTimer m_repaintClock;
+    qint64 m_lastPaintDuration;
+    bool m_isProcessingInput;
+
+    // event compression
+    bool m_isEventCompressionEnabled;
+    QScopedPointer<QMouseEvent> m_pendingMouseMove;
+    QScopedPointer<QTimer> m_inputTimer;
+    // time since the last processed input
+    QElapsedTimer m_inputClock;
+
+    bool m_isRenderStatsOverlayVisible;
+
 #if !defined(QT_NO_DEBUG)
     QPointer<QWidget> m_trackOwner;
 #endif
@@ -17,17 +17,58 @@
 #include "SpaceWidgetScrollAbstract.h"
 #include "cache/space/CacheSpace.h"
 #include "cache/CacheItem.h"
+#include "misc/CacheSpaceBackingStore.h"
+#include "utils/auto_value.h"
 
+#include <QApplication>
 #include <QScrollBar>
 #include <QKeyEvent>
+#include <QWheelEvent>
 
 namespace Qi
 {
 
+// larger scroll ranges are scaled to fit scroll bars
+static const qint64 MaxScrollBarRange = Q_INT64_C(1) << 30;
+
+static int scrollBarValue(qint64 position, qint64 range)
+{
+    if (range <= MaxScrollBarRange)
+        return int(position);
+
+    return int(qRound64(double(position) * MaxScrollBarRange / range));
+}
+
+static qint64 scrollBarPosition(int value, qint64 range)
+{
+    if (range <= MaxScrollBarRange)
+        return value;
+
+    return qRound64(double(value) * range / MaxScrollBarRange);
+}
+
+static void setScrollBarRange(QScrollBar* scrollBar, qint64 range, int pageStep)
+{
+    if (range <= MaxScrollBarRange)
+    {
+        scrollBar->setSingleStep(pageStep / 10);
+        scrollBar->setPageStep(pageStep);
+        scrollBar->setRange(0, int(range));
+    }
+    else
+    {
+        // steps in scaled units
+        scrollBar->setSingleStep(qMax(1, scrollBarValue(pageStep / 10, range)));
+        scrollBar->setPageStep(qMax(1, scrollBarValue(pageStep, range)));
+        scrollBar->setRange(0, int(MaxScrollBarRange));
+    }
+}
+
 SpaceWidgetScrollAbstract::SpaceWidgetScrollAbstract(QWidget* parent)
     : QAbstractScrollArea(parent),
       SpaceWidgetCore(viewport()),
-      m_isCacheItemsLayoutValid(false)
+      m_isCacheItemsLayoutValid(false),
+      m_isSyncingScrollBars(false)
 {
     // enable tracking mouse moves
     //viewport()->setMouseTracking(true);
@@ -39,6 +80,23 @@ SpaceWidgetScrollAbstract::~SpaceWidgetScrollAbstract()
 {
 }
 
+void SpaceWidgetScrollAbstract::setBackingStoreEnabled(bool enabled)
+{
+    if (isBackingStoreEnabled() == enabled)
+        return;
+
+    Q_ASSERT(!m_scrollableCacheSpace.isNull());
+    if (m_scrollableCacheSpace.isNull())
+        return;
+
+    if (enabled)
+        m_backingStore.reset(new CacheSpaceBackingStore(m_scrollableCacheSpace.data()));
+    else
+        m_backingStore.reset();
+
+    viewport()->update();
+}
+
 bool SpaceWidgetScrollAbstract::initSpaceWidgetScrollable(const QSharedPointer<CacheSpace>& mainCacheSpace, const QSharedPointer<CacheSpace>& scrollableCacheSpace)
 {
     // one time initialization allowed
@@ -70,6 +128,15 @@ void SpaceWidgetScrollAbstract::onScrollCacheSpaceChanged(const CacheSpace* cach
     }
 }
 
+qint64 SpaceWidgetScrollAbstract::memoryUsageImpl() const
+{
+    qint64 bytes = SpaceWidgetCore::memoryUsageImpl();
+    if (m_backingStore)
+        bytes += m_backingStore->memoryUsage();
+
+    return bytes;
+}
+
 void SpaceWidgetScrollAbstract::ensureVisibleImpl(const ItemID& visibleItem, const CacheSpace *cacheSpace, bool validateItem)
 {
     if (cacheSpace != m_scrollableCacheSpace.data())
@@ -86,22 +153,23 @@ void SpaceWidgetScrollAbstract::ensureVisibleImpl(const ItemID& visibleItem, con
     if (visibleSize.isEmpty())
         return;
 
-    QPoint scrollPos(horizontalScrollBar()->value(), verticalScrollBar()->value());
-    QRect itemRect = cacheSpace->space().itemRect(visibleItem);
+    SpacePoint scrollPos = m_scrollPosition;
+    SpacePoint itemPos = cacheSpace->space().itemPosition(visibleItem);
+    // item rectangle relative to item position
+    QRect itemRect = cacheSpace->space().localItemRect(visibleItem, itemPos);
 
-    if ((itemRect.width() >= visibleSize.width()) || (itemRect.left() < scrollPos.x()))
-        scrollPos.rx() = itemRect.left();
-    else if (itemRect.right() > (scrollPos.x() + visibleSize.width()))
-        scrollPos.rx() = itemRect.right() - visibleSize.width();
+    if ((itemRect.width() >= visibleSize.width()) || (itemPos.x < scrollPos.x))
+        scrollPos.x = itemPos.x;
+    else if (itemPos.x + itemRect.right() > (scrollPos.x + visibleSize.width()))
+        scrollPos.x = itemPos.x + itemRect.right() - visibleSize.width();
 
-    if ((itemRect.height() >= visibleSize.height()) || (itemRect.top() < scrollPos.y()))
-        scrollPos.ry() = itemRect.top();
-    else if (itemRect.bottom() > (scrollPos.y() + visibleSize.height()))
-        scrollPos.ry() = itemRect.bottom() - visibleSize.height();
+    if ((itemRect.height() >= visibleSize.height()) || (itemPos.y < scrollPos.y))
+        scrollPos.y = itemPos.y;
+    else if (itemPos.y + itemRect.bottom() > (scrollPos.y + visibleSize.height()))
+        scrollPos.y = itemPos.y + itemRect.bottom() - visibleSize.height();
 
     // scroll to new position
-    horizontalScrollBar()->setValue(scrollPos.x());
-    verticalScrollBar()->setValue(scrollPos.y());
+    setScrollPosition(scrollPos);
 
     if (validateItem)
     {
@@ -131,6 +199,15 @@ bool SpaceWidgetScrollAbstract::viewportEvent(QEvent* event)
         invalidateCacheItemsLayout();
         break;
 
+    case QEvent::StyleChange:
+    case QEvent::PaletteChange:
+    case QEvent::FontChange:
+    case QEvent::EnabledChange:
+        // rendered tiles are out of date
+        if (m_backingStore)
+            m_backingStore->invalidate();
+        break;
+
     default:
         ;
     }
@@ -154,21 +231,148 @@ void SpaceWidgetScrollAbstract::keyReleaseEvent(QKeyEvent *event)
 void SpaceWidgetScrollAbstract::focusInEvent(QFocusEvent * event)
 {
     QAbstractScrollArea::focusInEvent(event);
+    // active colors are used
+    if (m_backingStore)
+        m_backingStore->invalidate();
     processOwnerEvent(event);
 }
 
 void SpaceWidgetScrollAbstract::focusOutEvent(QFocusEvent * event)
 {
     QAbstractScrollArea::focusOutEvent(event);
+    // inactive colors are used
+    if (m_backingStore)
+        m_backingStore->invalidate();
     processOwnerEvent(event);
 }
 
 void SpaceWidgetScrollAbstract::scrollContentsBy(int dx, int dy)
 {
     QAbstractScrollArea::scrollContentsBy(dx, dy);
+
+    if (!m_isSyncingScrollBars)
+    {
+        // scroll bar has been moved by user
+        if (dx != 0)
+            m_scrollPosition.x = scrollBarPosition(horizontalScrollBar()->value(), m_scrollRange.x);
+        if (dy != 0)
+            m_scrollPosition.y = scrollBarPosition(verticalScrollBar()->value(), m_scrollRange.y);
+    }
+
+    updateCacheScrollOffsetImpl();
+}
+
+void SpaceWidgetScrollAbstract::wheelEvent(QWheelEvent* event)
+{
+    if (!isEventCompressionEnabled())
+    {
+        scrollByWheel(event);
+        return;
+    }
+
+    // let parent widgets scroll if the area is at the edge
+    if (!canScrollByWheel(*event))
+    {
+        event->ignore();
+        return;
+    }
+
+    // modifiers change scroll steps
+    if (m_pendingWheel.isPending && ((m_pendingWheel.modifiers != event->modifiers()) || (m_pendingWheel.inverted != event->inverted())))
+        flushPendingInput();
+
+    if (!m_pendingWheel.isPending)
+    {
+        m_pendingWheel.isPending = true;
+        m_pendingWheel.pos = event->position();
+        m_pendingWheel.globalPos = event->globalPosition();
+        m_pendingWheel.buttons = event->buttons();
+        m_pendingWheel.modifiers = event->modifiers();
+        m_pendingWheel.inverted = event->inverted();
+    }
+
+    // the latest phase describes the coalesced scroll
+    m_pendingWheel.phase = event->phase();
+
+    m_pendingWheel.pixelDelta += event->pixelDelta();
+    m_pendingWheel.angleDelta += event->angleDelta();
+    event->accept();
+
+    schedulePendingInput();
+}
+
+void SpaceWidgetScrollAbstract::processPendingInputImpl()
+{
+    if (!m_pendingWheel.isPending)
+        return;
+
+    PendingWheel wheel = m_pendingWheel;
+    m_pendingWheel = PendingWheel();
+
+    // scroll bars handle one orientation per event
+    if (wheel.angleDelta.x() != 0 || wheel.pixelDelta.x() != 0)
+    {
+        QWheelEvent event(wheel.pos, wheel.globalPos, QPoint(wheel.pixelDelta.x(), 0), QPoint(wheel.angleDelta.x(), 0), wheel.buttons, wheel.modifiers, wheel.phase, wheel.inverted);
+        scrollByWheel(&event);
+    }
+
+    if (wheel.angleDelta.y() != 0 || wheel.pixelDelta.y() != 0)
+    {
+        QWheelEvent event(wheel.pos, wheel.globalPos, QPoint(0, wheel.pixelDelta.y()), QPoint(0, wheel.angleDelta.y()), wheel.buttons, wheel.modifiers, wheel.phase, wheel.inverted);
+        scrollByWheel(&event);
+    }
+}
+
+bool SpaceWidgetScrollAbstract::canScrollByWheel(const QWheelEvent& event) const
+{
+    QPoint delta = event.angleDelta().isNull() ? event.pixelDelta() : event.angleDelta();
+
+    // positive delta scrolls to the beginning
+    if ((delta.x() > 0 && m_scrollPosition.x > 0) || (delta.x() < 0 && m_scrollPosition.x < m_scrollRange.x))
+        return true;
+    if ((delta.y() > 0 && m_scrollPosition.y > 0) || (delta.y() < 0 && m_scrollPosition.y < m_scrollRange.y))
+        return true;
+
+    return false;
+}
+
+void SpaceWidgetScrollAbstract::scrollByWheel(QWheelEvent* event)
+{
+    if (m_scrollRange.x <= MaxScrollBarRange && m_scrollRange.y <= MaxScrollBarRange)
+    {
+        QAbstractScrollArea::wheelEvent(event);
+        return;
+    }
+
+    // scaled scroll bars are too coarse, scroll by exact pixels
+    event->setAccepted(canScrollByWheel(*event));
+
+    QSize scrollStep = calculateScrollableSizeImpl() / 10;
+    QPoint angleDelta = event->angleDelta();
+    qint64 dx = qint64(angleDelta.x()) * QApplication::wheelScrollLines() * scrollStep.width() / 120;
+    qint64 dy = qint64(angleDelta.y()) * QApplication::wheelScrollLines() * scrollStep.height() / 120;
+
+    setScrollPosition(SpacePoint(m_scrollPosition.x - dx, m_scrollPosition.y - dy));
+}
+
+void SpaceWidgetScrollAbstract::setScrollPosition(const SpacePoint& scrollPosition)
+{
+    SpacePoint position(qBound(Q_INT64_C(0), scrollPosition.x, m_scrollRange.x), qBound(Q_INT64_C(0), scrollPosition.y, m_scrollRange.y));
+    if (m_scrollPosition == position)
+        return;
+
+    m_scrollPosition = position;
+    syncScrollBars();
     updateCacheScrollOffsetImpl();
 }
 
+void SpaceWidgetScrollAbstract::syncScrollBars()
+{
+    auto_value<bool> syncing(m_isSyncingScrollBars, true);
+    horizontalScrollBar()->setValue(scrollBarValue(m_scrollPosition.x, m_scrollRange.x));
+    verticalScrollBar()->setValue(scrollBarValue(m_scrollPosition.y, m_scrollRange.y));
+}
+
 QSize SpaceWidgetScrollAbstract::viewportSizeHint() const
 {
     return calculateVirtualSizeImpl();
@@ -179,29 +383,40 @@ void SpaceWidgetScrollAbstract::updateScrollbars()
     // client visible area only
     QSize scrollableSize = calculateScrollableSizeImpl();
 
-    // no space for scrollable area
-    if (scrollableSize.width() <= 0 || scrollableSize.height() <= 0)
-    {
-        // don't show scrollbars
-        verticalScrollBar()->setSingleStep(0);
-        verticalScrollBar()->setPageStep(0);
-        verticalScrollBar()->setRange(0, 0);
-        horizontalScrollBar()->setSingleStep(0);
-        horizontalScrollBar()->setPageStep(0);
-        horizontalScrollBar()->setRange(0, 0);
-    }
-    else
     {
-        QSize virtualSize = calculateVirtualSizeImpl();
-        // update vertical scrollbar
-        verticalScrollBar()->setSingleStep(scrollableSize.height() / 10);
-        verticalScrollBar()->setPageStep(scrollableSize.height());
-        verticalScrollBar()->setRange(0, qMax(0, virtualSize.height() - scrollableSize.height() + 2));
-        // update horizontal scrollbar
-        horizontalScrollBar()->setSingleStep(scrollableSize.width() / 10);
-        horizontalScrollBar()->setPageStep(scrollableSize.width());
-        horizontalScrollBar()->setRange(0, qMax(0, virtualSize.width() - scrollableSize.width() + 2));
+        // scroll position is corrected below
+        auto_value<bool> syncing(m_isSyncingScrollBars, true);
+
+        // no space for scrollable area
+        if (scrollableSize.width() <= 0 || scrollableSize.height() <= 0)
+        {
+            // don't show scrollbars
+            m_scrollRange = SpacePoint(0, 0);
+            verticalScrollBar()->setSingleStep(0);
+            verticalScrollBar()->setPageStep(0);
+            verticalScrollBar()->setRange(0, 0);
+            horizontalScrollBar()->setSingleStep(0);
+            horizontalScrollBar()->setPageStep(0);
+            horizontalScrollBar()->setRange(0, 0);
+        }
+        else
+        {
+            SpacePoint virtualExtent = calculateVirtualExtentImpl();
+            m_scrollRange.x = qMax(Q_INT64_C(0), virtualExtent.x - scrollableSize.width() + 2);
+            m_scrollRange.y = qMax(Q_INT64_C(0), virtualExtent.y - scrollableSize.height() + 2);
+            // update vertical scrollbar
+            setScrollBarRange(verticalScrollBar(), m_scrollRange.y, scrollableSize.height());
+            // update horizontal scrollbar
+            setScrollBarRange(horizontalScrollBar(), m_scrollRange.x, scrollableSize.width());
+        }
     }
+
+    // keep scroll position within new range
+    SpacePoint scrollPosition = m_scrollPosition;
+    m_scrollPosition = SpacePoint(qMin(scrollPosition.x, m_scrollRange.x), qMin(scrollPosition.y, m_scrollRange.y));
+    syncScrollBars();
+    if (m_scrollPosition != scrollPosition)
+        updateCacheScrollOffsetImpl();
 }
 
 QSize SpaceWidgetScrollAbstract::calculateVirtualSizeImpl() const
@@ -213,6 +428,15 @@ QSize SpaceWidgetScrollAbstract::calculateVirtualSizeImpl() const
     return m_scrollableCacheSpace->space().size();
 }
 
+SpacePoint SpaceWidgetScrollAbstract::calculateVirtualExtentImpl() const
+{
+    Q_ASSERT(!m_scrollableCacheSpace.isNull());
+    if (m_scrollableCacheSpace.isNull())
+        return SpacePoint(0, 0);
+
+    return m_scrollableCacheSpace->space().extent();
+}
+
 QSize SpaceWidgetScrollAbstract::calculateScrollableSizeImpl() const
 {
     return viewport()->size();
@@ -220,15 +444,12 @@ QSize SpaceWidgetScrollAbstract::calculateScrollableSizeImpl() const
 
 void SpaceWidgetScrollAbstract::updateCacheScrollOffsetImpl()
 {
-    // get scroll positions
-    QPoint scrollPos(horizontalScrollBar()->value(), verticalScrollBar()->value());
-
     // update scrollable cache scroll position
     Q_ASSERT(!m_scrollableCacheSpace.isNull());
     if (m_scrollableCacheSpace.isNull())
         return;
 
-    m_scrollableCacheSpace->setScrollOffset(scrollPos);
+    m_scrollableCacheSpace->setScrollPosition(m_scrollPosition);
 }
 
 void SpaceWidgetScrollAbstract::validateCacheItemsLayoutImpl()
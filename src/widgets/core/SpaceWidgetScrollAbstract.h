@@ -23,6 +23,8 @@
 namespace Qi
 {
 
+class CacheSpaceBackingStore;
+
 class QI_EXPORT SpaceWidgetScrollAbstract: public QAbstractScrollArea, public SpaceWidgetCore
 {
     Q_OBJECT
@@ -31,6 +33,15 @@ class QI_EXPORT SpaceWidgetScrollAbstract: public QAbstractScrollArea, public Sp
 public:
     virtual ~SpaceWidgetScrollAbstract();
 
+    // draws scrollable cache space through rendered tiles
+    bool isBackingStoreEnabled() const { return !m_backingStore.isNull(); }
+    void setBackingStoreEnabled(bool enabled);
+
+    // exact scroll position of the scrollable space
+    // scroll bars have scaled range if space is larger than int range
+    const SpacePoint& scrollPosition() const { return m_scrollPosition; }
+    void setScrollPosition(const SpacePoint& scrollPosition);
+
 protected:
     explicit SpaceWidgetScrollAbstract(QWidget *parent = nullptr);
 
@@ -42,10 +53,13 @@ protected:
     void focusInEvent(QFocusEvent * event) override;
     void focusOutEvent(QFocusEvent * event) override;
     void scrollContentsBy(int dx, int dy) override;
+    void wheelEvent(QWheelEvent* event) override;
     QSize viewportSizeHint() const override;
 
     // SpaceWidgetCore implementation
     void ensureVisibleImpl(const ItemID& visibleItem, const CacheSpace *cacheSpace, bool validateItem) override;
+    qint64 memoryUsageImpl() const override;
+    void processPendingInputImpl() override;
 
     void updateScrollbars();
     void invalidateCacheItemsLayout();
@@ -53,6 +67,7 @@ protected:
 
     virtual void validateCacheItemsLayoutImpl();
     virtual QSize calculateVirtualSizeImpl() const;
+    virtual SpacePoint calculateVirtualExtentImpl() const;
     virtual QSize calculateScrollableSizeImpl() const;
     virtual void updateCacheScrollOffsetImpl();
 
@@ -60,10 +75,37 @@ private:
     // hide method
     using SpaceWidgetCore::initSpaceWidgetCore;
     void onScrollCacheSpaceChanged(const CacheSpace* cache, ChangeReason reason);
+    void syncScrollBars();
+    // returns true if wheel event moves scroll position
+    bool canScrollByWheel(const QWheelEvent& event) const;
+    void scrollByWheel(QWheelEvent* event);
 
     QSharedPointer<CacheSpace> m_scrollableCacheSpace;
+    QScopedPointer<CacheSpaceBackingStore> m_backingStore;
 
     bool m_isCacheItemsLayoutValid;
+
+    SpacePoint m_scrollPosition;
+    SpacePoint m_scrollRange;
+    // scroll bars are updated from m_scrollPosition
+    bool m_isSyncingScrollBars;
+
+    // wheel deltas accumulated during the frame
+    struct PendingWheel
+    {
+        PendingWheel(): isPending(false), buttons(Qt::NoButton), modifiers(Qt::NoModifier), phase(Qt::NoScrollPhase), inverted(false) {}
+
+        bool isPending;
+        QPointF pos;
+        QPointF globalPos;
+        QPoint pixelDelta;
+        QPoint angleDelta;
+        Qt::MouseButtons buttons;
+        Qt::KeyboardModifiers modifiers;
+        Qt::ScrollPhase phase;
+        bool inverted;
+    };
+    PendingWheel m_pendingWheel;
 };
 
 } // end namespace Qi
@@ -3,6 +3,8 @@
 #include "test_ranges.h"
 #include "test_lines.h"
 #include "test_grid.h"
+#include "test_ring_buffer.h"
+#include "test_scene.h"
 
 #include <QtTest/QtTest>
 
@@ -20,6 +22,8 @@ int main(int argc, char* argv[])
     tests.append(&TestRanges::staticMetaObject);
     tests.append(&TestLines::staticMetaObject);
     tests.append(&TestGrid::staticMetaObject);
+    tests.append(&TestRingBuffer::staticMetaObject);
+    tests.append(&TestScene::staticMetaObject);
 
     // run tests
     foreach (const QMetaObject* testMetaObject, tests)
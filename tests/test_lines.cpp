@@ -1,5 +1,6 @@
 #include "test_lines.h"
 #include "space/Lines.h"
+#include "core/ext/ModelStore.h"
 #include "SignalSpy.h"
 #include <QtTest/QtTest>
 
@@ -265,22 +266,22 @@ void TestLines::testSizeAtLine()
     
     lines.setLineSizeAll(10);
     
-    QCOMPARE(lines.startPos(0), 0);
-    QCOMPARE(lines.startPos(1), 10);
-    QCOMPARE(lines.startPos(2), 20);
-    QCOMPARE(lines.startPos(3), 30);
-    QCOMPARE(lines.startPos(4), 40);
-    QCOMPARE(lines.startPos(5), 50);
-    QCOMPARE(lines.startPos(6), 60);
-    QCOMPARE(lines.startPos(7), 70);
-    QCOMPARE(lines.startPos(8), 80);
-    QCOMPARE(lines.startPos(9), 90);
+    QCOMPARE(lines.startPos(0), qint64(0));
+    QCOMPARE(lines.startPos(1), qint64(10));
+    QCOMPARE(lines.startPos(2), qint64(20));
+    QCOMPARE(lines.startPos(3), qint64(30));
+    QCOMPARE(lines.startPos(4), qint64(40));
+    QCOMPARE(lines.startPos(5), qint64(50));
+    QCOMPARE(lines.startPos(6), qint64(60));
+    QCOMPARE(lines.startPos(7), qint64(70));
+    QCOMPARE(lines.startPos(8), qint64(80));
+    QCOMPARE(lines.startPos(9), qint64(90));
     
     QCOMPARE(lines.findVisibleIDByPos(0), 0);
     QCOMPARE(lines.findVisibleIDByPos(10), 1);
     QCOMPARE(lines.findVisibleIDByPos(37), 3);
     
-    QCOMPARE(lines.visibleSize(), 100);
+    QCOMPARE(lines.visibleSize(), qint64(100));
     
     lines.setLineVisible(0, false);
     lines.setLineVisible(2, false);
@@ -320,12 +321,12 @@ void TestLines::testSizeAtLine()
     lines.setLineSize(9, 1);
     lines.setLineSize(6, 3);
     
-    QCOMPARE(lines.startPos(1), 30);
-    QCOMPARE(lines.startPos(2), 50);
-    QCOMPARE(lines.startPos(3), 50);
-    QCOMPARE(lines.startPos(4), 58);
-    QCOMPARE(lines.startPos(5), 59);
-    QCOMPARE(lines.startPos(6), 62);
+    QCOMPARE(lines.startPos(1), qint64(30));
+    QCOMPARE(lines.startPos(2), qint64(50));
+    QCOMPARE(lines.startPos(3), qint64(50));
+    QCOMPARE(lines.startPos(4), qint64(58));
+    QCOMPARE(lines.startPos(5), qint64(59));
+    QCOMPARE(lines.startPos(6), qint64(62));
     
     QCOMPARE(lines.findVisibleIDByPos(0), 0);
     QCOMPARE(lines.findVisibleIDByPos(10), 0);
@@ -339,6 +340,119 @@ void TestLines::testSizeAtLine()
     QCOMPARE(lines.findVisibleIDByPos(62), 5);
     QCOMPARE(lines.findVisibleIDByPos(159), 5);
     
-    QCOMPARE(lines.visibleSize(), 62);
+    QCOMPARE(lines.visibleSize(), qint64(62));
 }
 
+void TestLines::testSizeExceptions()
+{
+    Lines lines;
+    lines.setCount(100);
+    lines.setLineSizeAll(10);
+
+    // few lines with other sizes
+    lines.setLineSize(5, 30);
+    lines.setLineSize(50, 0);
+
+    QCOMPARE(lines.startPos(5), qint64(50));
+    QCOMPARE(lines.endPos(5), qint64(80));
+    QCOMPARE(lines.startPos(6), qint64(80));
+    QCOMPARE(lines.startPos(50), qint64(520));
+    QCOMPARE(lines.endPos(50), qint64(520));
+    QCOMPARE(lines.startPos(51), qint64(520));
+    QCOMPARE(lines.visibleSize(), qint64(1010));
+
+    QCOMPARE(lines.findVisibleIDByPos(49), 4);
+    QCOMPARE(lines.findVisibleIDByPos(50), 5);
+    QCOMPARE(lines.findVisibleIDByPos(79), 5);
+    QCOMPARE(lines.findVisibleIDByPos(80), 6);
+    QCOMPARE(lines.findVisibleIDByPos(519), 49);
+    QCOMPARE(lines.findVisibleIDByPos(520), 51);
+    QCOMPARE(lines.findVisibleIDByPos(1009), 99);
+    QCOMPARE(lines.findVisibleIDByPos(2000), 99);
+    QCOMPARE(lines.findVisibleIDByPos(2000, false), 100);
+    QCOMPARE(lines.findVisibleIDByPos(80, 2, 5), 5);
+    QCOMPARE(lines.findVisibleIDByPos(15, 2, 5), int(InvalidIndex));
+
+    // hidden lines shift positions
+    lines.setLineVisible(0, false);
+    QCOMPARE(lines.startPos(4), qint64(40));
+    QCOMPARE(lines.findVisibleIDByPos(45), 4);
+    QCOMPARE(lines.visibleSize(), qint64(1000));
+
+    // many different sizes
+    for (int i = 0; i < lines.count(); ++i)
+        lines.setLineSize(i, i % 3 + 1);
+    QCOMPARE(lines.startPos(3), qint64(2 + 3 + 1));
+    QCOMPARE(lines.findVisibleIDByPos(6), 3);
+}
+
+void TestLines::testLargeSize()
+{
+    Lines lines;
+    lines.setCount(3000000);
+    lines.setLineSizeAll(1000);
+
+    QCOMPARE(lines.visibleSize(), Q_INT64_C(3000000000));
+    QCOMPARE(lines.startPos(2999999), Q_INT64_C(2999999000));
+    QCOMPARE(lines.findVisibleIDByPos(Q_INT64_C(2999999000)), 2999999);
+    QCOMPARE(lines.findVisibleIDByPos(Q_INT64_C(2147483647)), 2147483);
+
+    // per line sizes
+    lines.setLineSize(0, 5000);
+    lines.setLineSize(1, 3000);
+    QCOMPARE(lines.visibleSize(), Q_INT64_C(3000006000));
+    QCOMPARE(lines.endPos(2999999), Q_INT64_C(3000006000));
+}
+
+void TestLines::testRemoveInsert()
+{
+    auto lines = QSharedPointer<Lines>::create(6);
+    for (int i = 0; i < lines->count(); ++i)
+        lines->setLineSize(i, i + 1);
+
+    auto model = QSharedPointer<ModelStorageColumn<int>>::create(lines);
+    for (int i = 0; i < lines->count(); ++i)
+        model->setValue(i, 0, i * 10);
+
+    // reversed order
+    lines->setPermutation(QVector<int>() << 5 << 4 << 3 << 2 << 1 << 0);
+
+    auto signalSpy = createSignalSpy(lines.data(), &Lines::linesChanged);
+
+    lines->removeLines(QVector<int>() << 4 << 1);
+    QCOMPARE(lines->count(), 4);
+    QCOMPARE(lines->permutation(), QVector<int>() << 3 << 2 << 1 << 0);
+    QCOMPARE(lines->lineSize(0), 1);
+    QCOMPARE(lines->lineSize(1), 3);
+    QCOMPARE(lines->lineSize(3), 6);
+    QCOMPARE(model->values(), QVector<int>() << 0 << 20 << 30 << 50);
+    QCOMPARE(signalSpy.size(), 1);
+    QCOMPARE(signalSpy.getLast<1>(), ChangeReasonLinesCount|ChangeReasonLinesCountWeak);
+
+    lines->insertLines(1, 2);
+    QCOMPARE(lines->count(), 6);
+    QCOMPARE(lines->permutation(), QVector<int>() << 5 << 4 << 1 << 2 << 3 << 0);
+    QCOMPARE(lines->lineSize(3), 3);
+    QCOMPARE(model->values(), QVector<int>() << 0 << 0 << 0 << 20 << 30 << 50);
+    QCOMPARE(signalSpy.size(), 2);
+
+    QCOMPARE(lines->insertVisibleLines(0), 0);
+    QCOMPARE(lines->toAbsolute(0), 6);
+    QCOMPARE(lines->toAbsolute(1), 5);
+
+    // per-line data compacted to one line stays per-line
+    lines->setCount(3);
+    lines->setLineVisible(0, false);
+    lines->setLineSize(0, 7);
+    lines->removeLines(QVector<int>() << 1 << 2);
+    QCOMPARE(lines->count(), 1);
+    QVERIFY(!lines->isLineVisible(0));
+    QCOMPARE(lines->lineSize(0), 7);
+
+    lines->insertLines(1, 2);
+    QVERIFY(!lines->isLineVisible(0));
+    QVERIFY(lines->isLineVisible(1));
+    QVERIFY(lines->isLineVisible(2));
+    QCOMPARE(lines->lineSize(0), 7);
+    QCOMPARE(lines->lineSize(1), 0);
+}
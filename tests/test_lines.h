@@ -17,6 +17,9 @@ private slots:
     void testSizes();
     void testAbsVsVis();
     void testSizeAtLine();
+    void testSizeExceptions();
+    void testLargeSize();
+    void testRemoveInsert();
 };
 
 #endif // TEST_LINES_H
@@ -228,3 +228,119 @@ void TestRanges::testRangeRows()
         QVERIFY(!r->hasItem(8, 8));
     }
 }
+
+void TestRanges::testRangeTouches()
+{
+    {
+        RangeRows r(1, 3);
+        QVERIFY(r.touchesRow(1));
+        QVERIFY(!r.touchesRow(4));
+        // rows range touches every column
+        QVERIFY(!r.hasColumn(5));
+        QVERIFY(r.touchesColumn(5));
+    }
+
+    {
+        RangeColumns r(2, 3);
+        QVERIFY(r.touchesColumn(2));
+        QVERIFY(!r.touchesColumn(0));
+        // columns range touches every row
+        QVERIFY(!r.hasRow(7));
+        QVERIFY(r.touchesRow(7));
+    }
+
+    {
+        RangeRect r(1, 2, 3, 4);
+        QVERIFY(r.touchesRow(1));
+        QVERIFY(!r.touchesRow(3));
+        QVERIFY(r.touchesColumn(3));
+        QVERIFY(!r.touchesColumn(4));
+    }
+
+    {
+        RangeRows r(QSet<int>());
+        QVERIFY(!r.touchesColumn(0));
+    }
+
+    {
+        // callbacks are not known by lines
+        RangeCallback r([](const ItemID& item) { return item.row == item.column; });
+        QVERIFY(r.touchesRow(10));
+        QVERIFY(r.touchesColumn(10));
+    }
+}
+
+void TestRanges::testRangeSelectionTouches()
+{
+    {
+        RangeSelection s;
+        QVERIFY(!s.touchesRow(0));
+        QVERIFY(!s.touchesColumn(0));
+    }
+
+    {
+        RangeSelection s;
+        s.addRange(makeRangeRows(2, 4), false);
+        QVERIFY(s.touchesRow(3));
+        QVERIFY(!s.touchesRow(5));
+        QVERIFY(s.touchesColumn(100));
+    }
+
+    {
+        RangeSelection s;
+        s.addRange(makeRangeColumns(1, 2), false);
+        QVERIFY(s.touchesRow(100));
+        QVERIFY(s.touchesColumn(1));
+        QVERIFY(!s.touchesColumn(2));
+    }
+
+    {
+        RangeSelection s;
+        s.addRange(makeRangeRect(0, 5, 0, 5), false);
+        s.addRange(makeRangeRow(2), true);
+        // partially excluded lines may have selected items
+        QVERIFY(s.touchesRow(1));
+        QVERIFY(s.touchesColumn(3));
+        QVERIFY(!s.touchesRow(6));
+        QVERIFY(!s.touchesColumn(6));
+    }
+
+    {
+        RangeSelection s;
+        s.addRange(makeRangeColumn(3), true);
+        // excluded ranges select nothing
+        QVERIFY(!s.touchesRow(0));
+        QVERIFY(!s.touchesColumn(3));
+    }
+}
+
+void TestRanges::testRangeSelectionItems()
+{
+    RangeSelection s;
+    s.addRange(makeRangeRows(1, 4), false);
+    s.addRange(makeRangeColumn(2), true);
+    s.addRange(makeRangeItem(ItemID(2, 2)), false);
+    s.addRange(makeRangeRect(5, 7, 0, 2), false);
+    s.addRange(QSharedPointer<RangeCallback>::create([](const ItemID& item) { return item.row == 6 && item.column == 0; }), true);
+
+    QVector<int> rows;
+    for (int row = 0; row < 8; ++row)
+        rows.append(row);
+    QVector<int> columns;
+    columns << 3 << 0 << 2 << 1;
+
+    QVector<QBitArray> items = s.selectedItems(rows, columns);
+    QCOMPARE(items.size(), rows.size());
+
+    for (int rowIndex = 0; rowIndex < rows.size(); ++rowIndex)
+    {
+        QCOMPARE(items[rowIndex].size(), columns.size());
+        for (int columnIndex = 0; columnIndex < columns.size(); ++columnIndex)
+            QCOMPARE(items[rowIndex].testBit(columnIndex), s.hasItem(rows[rowIndex], columns[columnIndex]));
+    }
+
+    QVERIFY(items[2].testBit(2));
+    QVERIFY(!items[3].testBit(2));
+    QVERIFY(!items[6].testBit(1));
+    QVERIFY(items[6].testBit(3));
+}
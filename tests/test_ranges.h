@@ -18,6 +18,9 @@ private slots:
     void testRangeColumns();
     void testRangeRow();
     void testRangeRows();
+    void testRangeTouches();
+    void testRangeSelectionTouches();
+    void testRangeSelectionItems();
 };
 
 #endif // TEST_RANGES_H
@@ -0,0 +1,143 @@
+#include "test_ring_buffer.h"
+#include "utils/RingBufferMPSC.h"
+#include "core/ext/ModelStoreChannel.h"
+#include "core/ext/ModelStore.h"
+#include "space/SpaceGrid.h"
+#include "SignalSpy.h"
+#include <QtTest/QtTest>
+#include <thread>
+#include <vector>
+
+using namespace Qi;
+
+void TestRingBuffer::testPushPop()
+{
+    RingBufferMPSC<int> ring(5);
+    QCOMPARE(ring.capacity(), 8);
+
+    int value = 0;
+    QVERIFY(!ring.pop(value));
+
+    QVERIFY(ring.push(1));
+    QVERIFY(ring.push(2));
+    QVERIFY(ring.pop(value));
+    QCOMPARE(value, 1);
+    QVERIFY(ring.pop(value));
+    QCOMPARE(value, 2);
+    QVERIFY(!ring.pop(value));
+}
+
+void TestRingBuffer::testFull()
+{
+    RingBufferMPSC<int> ring(4);
+
+    for (int i = 0; i < ring.capacity(); ++i)
+        QVERIFY(ring.push(i));
+
+    // record is dropped
+    QVERIFY(!ring.push(100));
+
+    int value = 0;
+    QVERIFY(ring.pop(value));
+    QCOMPARE(value, 0);
+
+    // freed cell is reused
+    QVERIFY(ring.push(4));
+
+    for (int i = 1; i <= 4; ++i)
+    {
+        QVERIFY(ring.pop(value));
+        QCOMPARE(value, i);
+    }
+
+    QVERIFY(!ring.pop(value));
+}
+
+void TestRingBuffer::testProducersOrder()
+{
+    const int producers = 4;
+    const int valuesPerProducer = 20000;
+
+    RingBufferMPSC<QPair<int, int>> ring(256);
+
+    std::vector<std::thread> threads;
+    for (int producer = 0; producer < producers; ++producer)
+    {
+        threads.emplace_back([&ring, producer, valuesPerProducer]() {
+            for (int i = 0; i < valuesPerProducer; )
+            {
+                // retry while consumer frees cells
+                if (ring.push(qMakePair(producer, i)))
+                    ++i;
+                else
+                    std::this_thread::yield();
+            }
+        });
+    }
+
+    // values of each producer come in push order
+    QVector<int> nextValues(producers, 0);
+    bool isOrdered = true;
+    int received = 0;
+    QPair<int, int> record;
+    while (received < producers * valuesPerProducer)
+    {
+        if (!ring.pop(record))
+            continue;
+
+        isOrdered = isOrdered && (record.second == nextValues[record.first]);
+        nextValues[record.first] = record.second + 1;
+        ++received;
+    }
+
+    for (auto& thread: threads)
+        thread.join();
+
+    QVERIFY(isOrdered);
+    for (int producer = 0; producer < producers; ++producer)
+        QCOMPARE(nextValues[producer], valuesPerProducer);
+
+    QVERIFY(!ring.pop(record));
+}
+
+void TestRingBuffer::testChannelDrain()
+{
+    auto grid = QSharedPointer<SpaceGrid>::create();
+    grid->setDimensions(10, 10);
+
+    auto model = QSharedPointer<ModelStorageGrid<int>>::create(grid);
+    ModelStoreChannel<int> channel(model, 16);
+
+    auto signalSpy = createSignalSpy(model.data(), &Model::modelChanged);
+
+    std::thread producer([&channel]() {
+        for (int i = 0; i < 5; ++i)
+            channel.push(ItemID(i, 1), i + 10);
+    });
+    producer.join();
+
+    QVERIFY(signalSpy.empty());
+
+    // single posted drain applies all records
+    QCoreApplication::sendPostedEvents(&channel);
+    QCOMPARE(signalSpy.size(), 1);
+    QCOMPARE(model->value(ItemID(0, 1)), 10);
+    QCOMPARE(model->value(ItemID(4, 1)), 14);
+
+    const ChangedItems& items = signalSpy.getLast<1>();
+    QCOMPARE(items.start(), ItemID(0, 1));
+    QCOMPARE(items.end(), ItemID(4, 1));
+
+    QCOMPARE(channel.drain(), 0);
+    QCOMPARE(signalSpy.size(), 1);
+
+    // full channel drops records
+    channel.setAutoDrain(false);
+    for (int i = 0; i < channel.capacity(); ++i)
+        QVERIFY(channel.push(ItemID(0, 0), i));
+    QVERIFY(!channel.push(ItemID(0, 0), -1));
+
+    QCOMPARE(channel.drain(), channel.capacity());
+    QCOMPARE(signalSpy.size(), 2);
+    QCOMPARE(model->value(ItemID(0, 0)), channel.capacity() - 1);
+}
@@ -0,0 +1,21 @@
+#ifndef TEST_RING_BUFFER_H
+#define TEST_RING_BUFFER_H
+
+#include <QObject>
+
+class TestRingBuffer: public QObject
+{
+    Q_OBJECT
+
+public:
+    Q_INVOKABLE TestRingBuffer() {}
+
+private slots:
+
+    void testPushPop();
+    void testFull();
+    void testProducersOrder();
+    void testChannelDrain();
+};
+
+#endif // TEST_RING_BUFFER_H
@@ -0,0 +1,124 @@
+#include "test_scene.h"
+#include "space/SpaceScene.h"
+#include <QtTest/QtTest>
+
+using namespace Qi;
+
+class TestNode: public SceneElement
+{
+public:
+    explicit TestNode(const QRect& rect): m_rect(rect) {}
+
+    void setRect(const QRect& rect) { m_rect = rect; }
+
+protected:
+    QRect rectImpl() const override { return m_rect; }
+    int typeImpl() const override { return SceneElementTypeNode; }
+
+private:
+    QRect m_rect;
+};
+
+// small nodes along the diagonal and one node over all of them
+static QVector<QRect> testRects()
+{
+    QVector<QRect> rects;
+    for (int i = 0; i < 50; ++i)
+        rects.append(QRect(i * 20, i * 20, 10, 10));
+    rects.insert(10, QRect(0, 0, 5000, 5000));
+    return rects;
+}
+
+static void fillScene(SpaceSceneElements& scene, const QVector<QRect>& rects)
+{
+    for (const auto& rect: rects)
+        scene.addElement(QSharedPointer<TestNode>::create(rect));
+}
+
+static QVector<ItemID> expectedInRect(const QVector<QRect>& rects, const QRect& rect)
+{
+    QVector<ItemID> items;
+    for (int i = 0; i < rects.size(); ++i)
+    {
+        if (rects[i].intersects(rect))
+            items.append(ItemID(0, i));
+    }
+    return items;
+}
+
+static QVector<ItemID> expectedAtPoint(const QVector<QRect>& rects, const QPoint& point)
+{
+    QVector<ItemID> items;
+    for (int i = 0; i < rects.size(); ++i)
+    {
+        if (rects[i].contains(point))
+            items.append(ItemID(0, i));
+    }
+    return items;
+}
+
+void TestScene::testItemsInRect()
+{
+    QVector<QRect> rects = testRects();
+    SpaceSceneElements scene;
+    fillScene(scene, rects);
+
+    QCOMPARE(scene.itemsInRect(QRect(0, 0, 15, 15)), expectedInRect(rects, QRect(0, 0, 15, 15)));
+    QCOMPARE(scene.itemsInRect(QRect(95, 95, 100, 100)), expectedInRect(rects, QRect(95, 95, 100, 100)));
+    QCOMPARE(scene.itemsInRect(QRect(-100, -100, 50, 50)), QVector<ItemID>());
+    QCOMPARE(scene.itemsInRect(QRect(6000, 0, 10, 10)), QVector<ItemID>());
+    // large node is found far from small ones
+    QCOMPARE(scene.itemsInRect(QRect(4000, 10, 10, 10)), QVector<ItemID>() << ItemID(0, 10));
+
+    QCOMPARE(scene.size(), QSize(4999, 4999));
+}
+
+void TestScene::testItemsAtPoint()
+{
+    QVector<QRect> rects = testRects();
+    SpaceSceneElements scene;
+    fillScene(scene, rects);
+
+    QCOMPARE(scene.itemsAtPoint(QPoint(5, 5)), expectedAtPoint(rects, QPoint(5, 5)));
+    QCOMPARE(scene.itemsAtPoint(QPoint(5, 5)).size(), 2);
+    QCOMPARE(scene.itemsAtPoint(QPoint(15, 15)), QVector<ItemID>() << ItemID(0, 10));
+    QCOMPARE(scene.itemsAtPoint(QPoint(985, 985)), expectedAtPoint(rects, QPoint(985, 985)));
+    QCOMPARE(scene.itemsAtPoint(QPoint(-1, 0)), QVector<ItemID>());
+}
+
+void TestScene::testElementsAppended()
+{
+    QVector<QRect> rects = testRects();
+    SpaceSceneElements scene;
+    fillScene(scene, rects);
+
+    // builds the index
+    QCOMPARE(scene.itemsAtPoint(QPoint(5, 5)).size(), 2);
+
+    // appended elements go to the existing index
+    QRect rect(7000, 7000, 10, 10);
+    rects.append(rect);
+    scene.addElement(QSharedPointer<TestNode>::create(rect));
+
+    QCOMPARE(scene.itemsAtPoint(QPoint(7005, 7005)), QVector<ItemID>() << ItemID(0, rects.size() - 1));
+    QCOMPARE(scene.itemsInRect(QRect(0, 0, 8000, 8000)), expectedInRect(rects, QRect(0, 0, 8000, 8000)));
+    QCOMPARE(scene.size(), QSize(7009, 7009));
+}
+
+void TestScene::testElementMoved()
+{
+    SpaceSceneElements scene;
+    auto node = QSharedPointer<TestNode>::create(QRect(0, 0, 10, 10));
+    scene.addElement(node);
+    scene.addElement(QSharedPointer<TestNode>::create(QRect(100, 100, 10, 10)));
+
+    QCOMPARE(scene.itemsAtPoint(QPoint(5, 5)), QVector<ItemID>() << ItemID(0, 0));
+
+    node->setRect(QRect(200, 200, 10, 10));
+    scene.notifyElementMoved(ItemID(0, 0));
+
+    QCOMPARE(scene.itemsAtPoint(QPoint(5, 5)), QVector<ItemID>());
+    QCOMPARE(scene.itemsAtPoint(QPoint(205, 205)), QVector<ItemID>() << ItemID(0, 0));
+    QCOMPARE(scene.itemsInRect(QRect(0, 0, 300, 300)), QVector<ItemID>() << ItemID(0, 0) << ItemID(0, 1));
+    QCOMPARE(scene.size(), QSize(209, 209));
+}
@@ -0,0 +1,21 @@
+#ifndef TEST_SCENE_H
+#define TEST_SCENE_H
+
+#include <QObject>
+
+class TestScene: public QObject
+{
+    Q_OBJECT
+
+public:
+    Q_INVOKABLE TestScene() {}
+
+private slots:
+
+    void testItemsInRect();
+    void testItemsAtPoint();
+    void testElementsAppended();
+    void testElementMoved();
+};
+
+#endif // TEST_SCENE_H
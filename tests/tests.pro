@@ -19,11 +19,15 @@ HEADERS +=  SignalSpy.h\
     test_item_id.h \
     test_ranges.h \
     test_lines.h \
-    test_grid.h
+    test_grid.h \
+    test_ring_buffer.h \
+    test_scene.h
 
 SOURCES +=  main.cpp \
     test_signal.cpp \
     test_item_id.cpp \
     test_ranges.cpp \
     test_lines.cpp \
-    test_grid.cpp
+    test_grid.cpp \
+    test_ring_buffer.cpp \
+    test_scene.cpp